@@ -0,0 +1,105 @@
+#pragma once
+/**
+ * @file bs_batch.h
+ * @brief Structure-of-arrays batch form of bs_price_call.
+ *
+ * Exposes:
+ *  - bs_price_call_batch(S,K,r,q,σ,T,out,n): out[i] = bs_price_call(S[i],...,T[i]).
+ *
+ * Inputs are processed in fixed chunks: a branch-free pass for the forward, discount
+ * factor and d1/d2, a pass for the two Φ evaluations over the lanes outside the
+ * small-σ√T regime, a gathered series pass over the lanes inside it, and a final
+ * combine, so the arithmetic passes vectorize.
+ * Results match the scalar bs_price_call bit for bit (strikes are assumed positive).
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "bs_call_price.h"
+
+namespace quant {
+
+inline constexpr std::size_t bs_batch_chunk = 64;
+
+namespace detail {
+
+// ln(F/K) exactly as bs_price_call forms it (log1p within 1e-12 of the money).
+inline double bs_log_moneyness(double F, double K) {
+    const double x = (F - K) / K;
+    return (std::abs(x) <= 1e-12) ? std::log1p(x) : std::log(F / K);
+}
+
+// Shared tail of every chunked kernel: the call price from DF, F, K, σ√T, d1, d2
+// (intrinsic forward value where σ√T == 0). Lanes in the small-σ√T regime take the
+// erfc-free series of bs_price_call. The chunk is split into index lists by regime and
+// each pass runs over its own lanes only: the series inputs are gathered so the
+// polynomial pass stays contiguous and vectorizes, and a mixed chunk pays for each
+// lane once. d1 and d2 are overwritten.
+inline void bs_chunk_finish(const double* DF, const double* F, const double* K, const double* sT,
+                            double* d1, double* d2, double* out, std::size_t m) {
+    bool small[bs_batch_chunk];
+    unsigned char lanes_small[bs_batch_chunk], lanes_erfc[bs_batch_chunk];
+    std::size_t n_small = 0, n_erfc = 0;
+    for (std::size_t i = 0; i < m; ++i) {
+        small[i] = bs_small_vol_regime(sT[i], d1[i]);
+        lanes_small[n_small] = lanes_erfc[n_erfc] = static_cast<unsigned char>(i);
+        n_small += small[i];
+        n_erfc += !small[i];
+    }
+    double series[bs_batch_chunk];
+    if (n_small > 0) {
+        // Same arithmetic as bs_small_vol_terms, on gathered lanes so the polynomial pass vectorizes
+        double s[bs_batch_chunk], x[bs_batch_chunk];
+        double Ph[bs_batch_chunk], ph[bs_batch_chunk], odd[bs_batch_chunk], even[bs_batch_chunk];
+        for (std::size_t j = 0; j < n_small; ++j) {
+            s[j] = sT[lanes_small[j]];
+            x[j] = d1[lanes_small[j]];
+        }
+        for (std::size_t j = 0; j < n_small; ++j)
+            bs_small_vol_series(s[j], x[j], Ph[j], ph[j], odd[j], even[j]);
+        for (std::size_t j = 0; j < n_small; ++j) {
+            const std::size_t i = lanes_small[j];
+            const SmallVolTerms t{Ph[j], ph[j], odd[j], even[j]};
+            series[i] = t.call_undiscounted(F[i], K[i]);
+        }
+    }
+    for (std::size_t j = 0; j < n_erfc; ++j) {
+        const std::size_t i = lanes_erfc[j];
+        d1[i] = Phi_real(d1[i]);
+        d2[i] = Phi_real(d2[i]);
+    }
+    for (std::size_t i = 0; i < m; ++i) {
+        const double diffusive = small[i] ? DF[i] * series[i] : DF[i] * (F[i] * d1[i] - K[i] * d2[i]);
+        const double intrinsic = DF[i] * std::max(F[i] - K[i], 0.0);
+        out[i] = sT[i] > 0.0 ? diffusive : intrinsic;
+    }
+}
+
+} // namespace detail
+
+inline void bs_price_call_batch(const double* S, const double* K, const double* r, const double* q,
+                                const double* sigma, const double* T, double* out, std::size_t n) {
+    double DF[bs_batch_chunk], F[bs_batch_chunk], sT[bs_batch_chunk];
+    double d1[bs_batch_chunk], d2[bs_batch_chunk];
+
+    for (std::size_t base = 0; base < n; base += bs_batch_chunk) {
+        const std::size_t m = std::min(bs_batch_chunk, n - base);
+        const double *Sc = S + base, *Kc = K + base, *rc = r + base, *qc = q + base;
+        const double *vc = sigma + base, *Tc = T + base;
+
+        for (std::size_t i = 0; i < m; ++i) {
+            DF[i] = std::exp(-rc[i] * Tc[i]);
+            F[i]  = Sc[i] * std::exp((rc[i] - qc[i]) * Tc[i]);
+            sT[i] = vc[i] * std::sqrt(std::max(Tc[i], 0.0));
+            const double ln = detail::bs_log_moneyness(F[i], Kc[i]);
+            const double sT_safe = sT[i] > 0.0 ? sT[i] : 1.0;
+            d1[i] = (ln + 0.5 * vc[i] * vc[i] * Tc[i]) / sT_safe;
+            d2[i] = d1[i] - sT_safe;
+        }
+        detail::bs_chunk_finish(DF, F, Kc, sT, d1, d2, out + base, m);
+    }
+}
+
+} // namespace quant
@@ -0,0 +1,1513 @@
+/**
+ * @file bs_benchmark.cpp
+ * @brief Benchmarks and cross-checks for the Monte Carlo / batch kernels.
+ *
+ * Each section prices against the closed-form bs_price_call and reports
+ * accuracy together with wall-clock time.
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <complex>
+#include <array>
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include "bs_call_price.h"
+#include "rqmc.h"
+#include "variance_reduction.h"
+#include "mc_engine.h"
+#include "mc_term_strip.h"
+#include "merton_jump.h"
+#include "bs_bump.h"
+#include "bs_complex_step.h"
+#include "bs_greeks.h"
+#include "bs_adjoint.h"
+#include "normalised_black.h"
+#include "bs_ladder.h"
+#include "option_book.h"
+#include "huge_page_alloc.h"
+#include "task_scheduler.h"
+#include "task_graph.h"
+#include "stream_pipeline.h"
+#include "async_writer.h"
+#include "columnar_codec.h"
+#include "sweep_engine.h"
+#include "result_cache.h"
+#include "step_search.h"
+
+using namespace std;
+
+// Wall-clock seconds since an arbitrary epoch
+static double now_seconds() {
+    using clock = chrono::steady_clock;
+    return chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+// European call on GBM, discounted terminal payoff for one standard normal
+struct EuropeanCallPayoff {
+    double S, K, r, q, sigma, T;
+
+    double operator()(const double* z, size_t /*dims*/) const {
+        const double drift = (r - q - 0.5 * sigma * sigma) * T;
+        const double ST = S * exp(drift + sigma * sqrt(T) * z[0]);
+        return exp(-r * T) * max(ST - K, 0.0);
+    }
+};
+
+// Randomized QMC
+
+void bench_rqmc() {
+    cout << "\n=== Randomized QMC (Owen-scrambled Sobol) ===" << endl;
+    const EuropeanCallPayoff call{100.0, 100.0, 0.02, 0.0, 0.20, 1.0};
+    const double exact = bs_price_call(call.S, call.K, call.r, call.q, call.sigma, call.T);
+
+    for (size_t log2_n : {10u, 12u, 14u}) {
+        const double t0 = now_seconds();
+        const quant::RQMCResult res = quant::rqmc_estimate(call, 1, log2_n, 16);
+        const double t1 = now_seconds();
+        cout << "  n=2^" << log2_n << " x 16 reps: price=" << res.mean
+             << "  se=" << res.std_error << "  |err|=" << abs(res.mean - exact)
+             << "  time=" << (t1 - t0) << "s" << endl;
+    }
+
+    const double target = 2e-4;
+    const double t0 = now_seconds();
+    const quant::RQMCResult seq = quant::rqmc_estimate_to_tolerance(call, 1, 13, target);
+    const double t1 = now_seconds();
+    cout << "  sequential stop (target se=" << target << "): reps=" << seq.replicates
+         << "  price=" << seq.mean << "  se=" << seq.std_error
+         << "  |err|=" << abs(seq.mean - exact) << "  time=" << (t1 - t0) << "s" << endl;
+    cout << "  closed form = " << exact << endl;
+}
+
+// Variance reduction for deep-OTM calls
+
+void bench_variance_reduction() {
+    cout << "\n=== Variance reduction (deep OTM calls) ===" << endl;
+    const size_t n = 1 << 16;
+    struct Method { const char* name; quant::VarianceReduction vr; };
+    const Method methods[] = {
+        {"plain",               {}},
+        {"antithetic",          {true, false, false, false}},
+        {"moment matching",     {false, true, false, false}},
+        {"stratified",          {false, false, true, false}},
+        {"importance",          {false, false, false, true}},
+        {"IS + stratified",     {false, false, true, true}},
+        {"IS + strat + anti",   {true, false, true, true}},
+    };
+
+    for (double K : {130.0, 160.0, 200.0}) {
+        const double S = 100.0, r = 0.02, q = 0.0, sigma = 0.20, T = 1.0;
+        const double exact = bs_price_call(S, K, r, q, sigma, T);
+        cout << "  K/S=" << K / S << "  closed form=" << exact
+             << "  shift mu=" << quant::optimal_is_shift(S, K, r, q, sigma, T) << endl;
+
+        double var_plain = 0.0;
+        for (const Method& m : methods) {
+            const double t0 = now_seconds();
+            const quant::MCEstimate est = quant::mc_price_call(S, K, r, q, sigma, T, n, m.vr);
+            const double t1 = now_seconds();
+            const double var = est.std_error * est.std_error * static_cast<double>(est.paths);
+            if (var_plain == 0.0) var_plain = var;
+            // Paths needed for a 1% relative standard error
+            const double paths_1pct = var / (0.01 * exact) / (0.01 * exact);
+            cout << "    " << left << setw(18) << m.name << right
+                 << " price=" << est.mean << "  se=" << est.std_error
+                 << "  |err|/se=" << abs(est.mean - exact) / est.std_error
+                 << "  VRF=" << var_plain / var
+                 << "  paths@1%=" << paths_1pct
+                 << "  time=" << (t1 - t0) << "s" << endl;
+        }
+    }
+}
+
+// Sequential stopping in the MC engine
+
+void bench_sequential_stopping() {
+    cout << "\n=== MC engine: standard-error target vs fixed path count ===" << endl;
+    struct Trade { const char* name; double S, K, r, q, sigma, T; };
+    const Trade trades[] = {
+        {"ATM 1y",         100.0, 100.0, 0.02, 0.00, 0.20, 1.00},
+        {"low vol 3m",     100.0, 100.0, 0.02, 0.00, 0.05, 0.25},
+        {"short-dated 1w", 100.0, 102.0, 0.02, 0.00, 0.15, 7.0 / 365.0},
+        {"OTM 6m",         100.0, 120.0, 0.02, 0.01, 0.25, 0.50},
+        {"high vol 2y",    100.0,  90.0, 0.02, 0.00, 0.60, 2.00},
+    };
+
+    quant::MCConfig fixed;
+    fixed.max_paths = size_t(1) << 18;
+    quant::MCConfig target = fixed;
+    target.target_se = 0.02;
+
+    double cpu_fixed = 0.0, cpu_target = 0.0;
+    for (const Trade& tr : trades) {
+        const double exact = bs_price_call(tr.S, tr.K, tr.r, tr.q, tr.sigma, tr.T);
+        const EuropeanCallPayoff call{tr.S, tr.K, tr.r, tr.q, tr.sigma, tr.T};
+        auto kernel = [&](uint64_t seed, double* payoff, size_t n) {
+            quant::fill_normals(seed, payoff, n);
+            for (size_t i = 0; i < n; ++i) payoff[i] = call(&payoff[i], 1);
+        };
+
+        double t0 = now_seconds();
+        const quant::MCResult a = quant::mc_run(fixed, kernel);
+        double t1 = now_seconds();
+        const quant::MCResult b = quant::mc_run(target, kernel);
+        double t2 = now_seconds();
+        cpu_fixed += t1 - t0;
+        cpu_target += t2 - t1;
+
+        cout << "  " << left << setw(15) << tr.name << right
+             << " fixed: paths=" << a.paths << " se=" << a.std_error
+             << "  | target " << target.target_se << ": paths=" << b.paths << " se=" << b.std_error
+             << " |err|=" << abs(b.mean - exact)
+             << (b.converged ? "" : " (budget hit)")
+             << "  saved=" << 100.0 * (1.0 - double(b.paths) / double(a.paths)) << "%" << endl;
+    }
+    cout << "  total time: fixed=" << cpu_fixed << "s  target=" << cpu_target
+         << "s  saved=" << 100.0 * (1.0 - cpu_target / cpu_fixed) << "%" << endl;
+}
+
+// Shared-path MC for a term-structure strip
+
+void bench_term_strip() {
+    cout << "\n=== Shared-path MC: 12 expiries x 5 strikes ===" << endl;
+    const double S = 100.0, r = 0.02, q = 0.01, sigma = 0.25;
+    vector<quant::StripExpiry> strip;
+    for (int m = 1; m <= 12; ++m) strip.push_back({m / 12.0, {80.0, 90.0, 100.0, 110.0, 120.0}});
+
+    quant::MCConfig cfg;
+    cfg.max_paths = size_t(1) << 15;
+
+    double t0 = now_seconds();
+    const quant::StripResult shared = quant::mc_price_strip(S, r, q, sigma, strip, cfg);
+    double t1 = now_seconds();
+
+    // Per expiry: worst |MC - closed form| in units of its standard error
+    size_t k = 0;
+    for (const quant::StripExpiry& e : strip) {
+        double worst = 0.0;
+        for (size_t j = 0; j < e.strikes.size(); ++j, ++k) {
+            const quant::StripQuote& qt = shared.quotes[k];
+            worst = max(worst, abs(qt.price - bs_price_call(S, qt.K, r, q, sigma, qt.T)) / qt.std_error);
+        }
+        cout << "  T=" << setw(12) << left << e.T << right << " max |err|/se=" << worst << endl;
+    }
+
+    // Same options, one simulation each
+    double t2 = now_seconds();
+    for (const quant::StripExpiry& e : strip) {
+        for (double K : e.strikes) {
+            const EuropeanCallPayoff call{S, K, r, q, sigma, e.T};
+            quant::mc_run(cfg, [&](uint64_t seed, double* payoff, size_t n) {
+                quant::fill_normals(seed, payoff, n);
+                for (size_t i = 0; i < n; ++i) payoff[i] = call(&payoff[i], 1);
+            });
+        }
+    }
+    double t3 = now_seconds();
+    cout << "  one shared simulation: " << (t1 - t0) << "s   60 separate simulations: " << (t3 - t2)
+         << "s   speed-up=" << (t3 - t2) / (t1 - t0) << "x" << endl;
+}
+
+// Merton jump-diffusion series vs jump MC
+
+void bench_merton() {
+    cout << "\n=== Merton jump-diffusion: series kernel vs jump MC ===" << endl;
+    const double S = 100.0, r = 0.03, q = 0.01, sigma = 0.20, T = 0.75;
+    const quant::MertonParams jp{0.8, -0.10, 0.15};
+    const double kappa = expm1(jp.mu_j + 0.5 * jp.delta * jp.delta);
+
+    const double no_jumps = quant::merton_price_call(S, 105.0, r, q, sigma, T, {0.0, 0.0, 0.0}).price;
+    cout << "  lambda=0 vs bs_price_call: |diff|=" << abs(no_jumps - bs_price_call(S, 105.0, r, q, sigma, T)) << endl;
+    for (double K : {95.0, 105.0}) {
+        const quant::MertonGreeks g0 = quant::merton_cs_greeks(S, K, r, q, sigma, 0.0, jp);
+        cout << "  T=0, K=" << K << ": price=" << g0.price << " (intrinsic " << bs_price_call(S, K, r, q, sigma, 0.0)
+             << ")  delta=" << g0.delta << " gamma=" << g0.gamma << " vega=" << g0.vega << endl;
+    }
+    {
+        // σ = 0: jumps still diffuse the price; only the no-jump term is the forward payoff
+        const quant::MertonGreeks g0 = quant::merton_cs_greeks(S, 105.0, r, q, 0.0, T, jp);
+        const double hs = 1e-4 * S;
+        auto p0 = [&](double s) { return quant::merton_price_call(s, 105.0, r, q, 0.0, T, jp).price; };
+        cout << "  sigma=0, K=105: price=" << g0.price << "  delta=" << g0.delta << " (FD "
+             << (p0(S + hs) - p0(S - hs)) / (2.0 * hs) << ")  gamma=" << g0.gamma << " vega=" << g0.vega << endl;
+    }
+
+    quant::MCConfig cfg;
+    cfg.max_paths = size_t(1) << 18;
+    for (double K : {70.0, 100.0, 130.0}) {
+        const double t0 = now_seconds();
+        const quant::MertonPrice series = quant::merton_price_call(S, K, r, q, sigma, T, jp);
+        const double t1 = now_seconds();
+
+        // Terminal log-price: diffusion + compensated compound Poisson of normal log-jumps
+        const quant::MCResult mc = quant::mc_run(cfg, [&](uint64_t seed, double* payoff, size_t n) {
+            thread_local vector<double> z;
+            z.resize(2 * n);
+            quant::fill_normals(seed, z.data(), 2 * n);
+            mt19937_64 rng(seed ^ 0x9e3779b97f4a7c15ull);
+            poisson_distribution<int> jumps(jp.lambda * T);
+            const double drift = (r - q - jp.lambda * kappa - 0.5 * sigma * sigma) * T;
+            for (size_t i = 0; i < n; ++i) {
+                const int N = jumps(rng);
+                const double J = N * jp.mu_j + sqrt(double(N)) * jp.delta * z[2 * i + 1];
+                const double ST = S * exp(drift + sigma * sqrt(T) * z[2 * i] + J);
+                payoff[i] = exp(-r * T) * max(ST - K, 0.0);
+            }
+        });
+
+        const quant::MertonGreeks g = quant::merton_cs_greeks(S, K, r, q, sigma, T, jp);
+        const double hs = 1e-4 * S, hv = 1e-5;
+        auto price = [&](double s, double v) { return quant::merton_price_call(s, K, r, q, v, T, jp).price; };
+        const double delta_fd = (price(S + hs, sigma) - price(S - hs, sigma)) / (2.0 * hs);
+        const double gamma_fd = (price(S + hs, sigma) - 2.0 * series.price + price(S - hs, sigma)) / (hs * hs);
+        const double vega_fd  = (price(S, sigma + hv) - price(S, sigma - hv)) / (2.0 * hv);
+
+        cout << "  K=" << K << "  series=" << series.price << " (" << series.terms << " terms, "
+             << (t1 - t0) * 1e6 << "us)  MC=" << mc.mean << " +/- " << mc.std_error
+             << "  |err|/se=" << abs(mc.mean - series.price) / mc.std_error << endl;
+        cout << "         CS delta=" << g.delta << " gamma=" << g.gamma << " vega=" << g.vega
+             << "  |CS-FD|: " << abs(g.delta - delta_fd) << ", " << abs(g.gamma - gamma_fd)
+             << ", " << abs(g.vega - vega_fd) << endl;
+    }
+}
+
+// Multi-bump pricing vs repeated bs_price_call
+
+void bench_bump_kernel() {
+    cout << "\n=== Bump-and-reprice kernel vs repeated bs_price_call ===" << endl;
+    const quant::BSInput base{100.0, 105.0, 0.03, 0.01, 0.22, 0.8};
+    const char* axis_name[] = {"spot", "vol", "rate", "time"};
+    const quant::BumpAxis axes[] = {quant::BumpAxis::Spot, quant::BumpAxis::Vol,
+                                    quant::BumpAxis::Rate, quant::BumpAxis::Time};
+    const int reps = 5000;
+
+    for (size_t n : {3u, 5u, 9u, 17u}) {
+        vector<double> bumps(n), out(n), ref(n);
+        for (size_t i = 0; i < n; ++i) bumps[i] = 1e-3 * (double(i) - double(n / 2));
+
+        for (int a = 0; a < 4; ++a) {
+            // Best of five trials each: single runs on a shared core vary by ±20%.
+            double sink = 0.0, scalar = 1e300, kernel = 1e300;
+            for (int trial = 0; trial < 5; ++trial) {
+                double t0 = now_seconds();
+                for (int k = 0; k < reps; ++k) {
+                    for (size_t i = 0; i < n; ++i) {
+                        quant::BSInput x = base;
+                        double* field[] = {&x.S, &x.sigma, &x.r, &x.T};
+                        *field[a] += bumps[i];
+                        ref[i] = bs_price_call(x.S, x.K, x.r, x.q, x.sigma, x.T);
+                    }
+                    sink += ref[0];
+                }
+                double t1 = now_seconds();
+                for (int k = 0; k < reps; ++k) {
+                    quant::bs_price_call_bumped(base, axes[a], bumps.data(), out.data(), n);
+                    sink += out[0];
+                }
+                double t2 = now_seconds();
+                scalar = min(scalar, (t1 - t0) / reps * 1e9);
+                kernel = min(kernel, (t2 - t1) / reps * 1e9);
+            }
+
+            double diff = 0.0;
+            for (size_t i = 0; i < n; ++i) diff = max(diff, abs(out[i] - ref[i]));
+            cout << "  " << setw(2) << n << " " << setw(4) << axis_name[a] << " bumps: scalar="
+                 << scalar << "ns  kernel=" << kernel << "ns  (" << scalar / kernel << "x, "
+                 << kernel / (scalar / double(n)) << " pricings)  max|diff|=" << diff
+                 << (sink == 0.0 ? " " : "") << endl;
+        }
+    }
+}
+
+// Fused complex-step stencil (S+ih, S+hω, S-hω)
+
+void bench_fused_complex_step() {
+    cout << "\n=== Complex-step delta + 45-degree gamma: fused kernel ===" << endl;
+    using C = complex<double>;
+    const double S = 100.0, K = 105.0, r = 0.03, q = 0.01, sigma = 0.22, T = 0.8, h = 1e-6 * S;
+    const C omega(1.0 / sqrt(2.0), 1.0 / sqrt(2.0));
+    const C spots[3] = {C(S, h), S + h * omega, S - h * omega};
+    const int reps = 50000;
+
+    C ref[3], out[3];
+    double sink = 0.0;
+    double t0 = now_seconds();
+    for (int k = 0; k < reps; ++k) {
+        for (int i = 0; i < 3; ++i)
+            ref[i] = bs_price_call_t<C>(spots[i], C(K), C(r), C(q), C(sigma), C(T));
+        sink += ref[0].imag();
+    }
+    double t1 = now_seconds();
+    for (int k = 0; k < reps; ++k) {
+        bs_price_call_cs_spots(spots, K, r, q, sigma, T, out, 3, 1);
+        sink += out[0].imag();
+    }
+    double t2 = now_seconds();
+    C im_only[3];
+    for (int k = 0; k < reps; ++k) {
+        bs_price_call_cs_spots(spots, K, r, q, sigma, T, im_only, 3, 0);
+        sink += im_only[0].imag();
+    }
+    double t2b = now_seconds();
+    volatile double bump = 0.0;   // keeps the two real pricings inside the loop
+    for (int k = 0; k < reps; ++k) {
+        sink += bs_price_call(S + bump, K, r, q, sigma, T);
+        sink += bs_price_call(S + h + bump, K, r, q, sigma, T);
+    }
+    double t3 = now_seconds();
+
+    // Lanes 1-2 carry the imaginary part only
+    double diff = abs(out[0] - ref[0]);
+    for (int i = 1; i < 3; ++i) diff = max(diff, abs(out[i].imag() - ref[i].imag()));
+    cout << "  3 x bs_price_call_t: " << (t1 - t0) / reps * 1e9 << "ns   fused (with Re C(S+ih)): "
+         << (t2 - t1) / reps * 1e9 << "ns   fused (delta + 45-degree gamma, Im only): "
+         << (t2b - t2) / reps * 1e9 << "ns   2 real pricings: " << (t3 - t2b) / reps * 1e9
+         << "ns   max|diff|=" << diff << (sink == 0.0 ? " " : "") << endl;
+}
+
+// Step-size sweep: h as the lane dimension
+
+void bench_h_grid() {
+    cout << "\n=== Step-size sweep: per-h calls vs h-grid kernel ===" << endl;
+    const double S = 100.0, K = 100.0, r = 0.0, q = 0.0, sigma = 0.20, T = 1.0;
+    for (int points : {25, 241}) {
+        vector<double> h;
+        for (int i = 0; i < points; ++i) h.push_back(S * pow(10.0, -16.0 + i * (12.0 / (points - 1))));
+        const int reps = 2000 * 25 / points;
+
+        double sink = 0.0, diff = 0.0;
+        double t0 = now_seconds();
+        for (int k = 0; k < reps; ++k)
+            for (double hi : h) {
+                sink += compute_fd_greeks(S, K, r, q, sigma, T, hi).gamma;
+                sink += compute_cs_greeks(S, K, r, q, sigma, T, hi).gamma_45;
+            }
+        double t1 = now_seconds();
+        HGridGreeks grid;
+        for (int k = 0; k < reps; ++k) {
+            grid = compute_greeks_h_grid(S, K, r, q, sigma, T, h);
+            sink += grid.cs[0].gamma_45;
+        }
+        double t2 = now_seconds();
+        for (size_t i = 0; i < h.size(); ++i) {
+            const CSGreeks cs = compute_cs_greeks(S, K, r, q, sigma, T, h[i]);
+            const FDGreeks fd = compute_fd_greeks(S, K, r, q, sigma, T, h[i]);
+            diff = max({diff, abs(cs.gamma_45 - grid.cs[i].gamma_45), abs(fd.gamma - grid.fd[i].gamma),
+                        abs(cs.delta - grid.cs[i].delta), abs(cs.gamma_real - grid.cs[i].gamma_real)});
+        }
+        cout << "  " << points << " steps: per-h=" << (t1 - t0) / reps * 1e6 << "us  grid="
+             << (t2 - t1) / reps * 1e6 << "us  (" << (t1 - t0) / (t2 - t1) << "x)  max|diff|=" << diff
+             << (sink == 0.0 ? " " : "") << endl;
+    }
+}
+
+// Adaptive optimal-step search vs fixed log grids
+
+void bench_adaptive_steps() {
+    cout << "\n=== Optimal step: adaptive search vs fixed log grids ===" << endl;
+    const double S = 100.0, K = 100.0, r = 0.0, q = 0.0, sigma = 0.20, T = 1.0;
+    const AnalyticGreeks a = compute_analytic_greeks(S, K, r, q, sigma, T);
+
+    // h_rel = 10^-16 .. 10^-4: the validation sweep's 0.5-decade grid, and a 0.1-decade
+    // grid at the adaptive search's resolution
+    auto log_grid = [&](double decades_per_step) {
+        vector<double> h;
+        const int points = int(lround(12.0 / decades_per_step)) + 1;
+        for (int i = 0; i < points; ++i) h.push_back(S * pow(10.0, -16.0 + i * decades_per_step));
+        return h;
+    };
+    const vector<double> h25 = log_grid(0.5), h121 = log_grid(0.1);
+
+    // Best of five trials: single runs on a shared core vary by ±20%.
+    const int reps = 200;
+    double t25 = 1e300, t121 = 1e300, tad = 1e300;
+    HGridGreeks g25, g121;
+    vector<StepOptimum> best;
+    for (int trial = 0; trial < 5; ++trial) {
+        double t0 = now_seconds();
+        for (int k = 0; k < reps; ++k) g25 = compute_greeks_h_grid(S, K, r, q, sigma, T, h25);
+        double t1 = now_seconds();
+        for (int k = 0; k < reps; ++k) g121 = compute_greeks_h_grid(S, K, r, q, sigma, T, h121);
+        double t2 = now_seconds();
+        for (int k = 0; k < reps; ++k) best = find_optimal_steps(S, K, r, q, sigma, T);
+        double t3 = now_seconds();
+        t25 = min(t25, (t1 - t0) / reps * 1e6);
+        t121 = min(t121, (t2 - t1) / reps * 1e6);
+        tad = min(tad, (t3 - t2) / reps * 1e6);
+    }
+
+    auto grid_min = [&](GreekMethod m, const HGridGreeks& g) {
+        double e = detail::grid_error(m, g, 0, a);
+        for (size_t i = 1; i < g.fd.size(); ++i) e = min(e, detail::grid_error(m, g, i, a));
+        return e;
+    };
+    int evals = 0;
+    for (const StepOptimum& o : best) {
+        cout << "  " << left << setw(14) << greek_method_name(o.method) << right
+             << " adaptive err=" << o.error << " (" << o.evaluations << " evals)  0.5-decade grid err="
+             << grid_min(o.method, g25) << "  0.1-decade grid err=" << grid_min(o.method, g121) << endl;
+        evals += o.evaluations;
+    }
+    cout << "  evaluations (steps x methods): adaptive=" << evals << "  0.5-decade grid=" << h25.size() * 5
+         << "  0.1-decade grid=" << h121.size() * 5 << endl;
+    cout << "  time: adaptive=" << tad << "us  0.5-decade grid=" << t25 << "us (" << t25 / tad
+         << "x)  0.1-decade grid=" << t121 << "us (" << t121 / tad << "x)" << endl;
+}
+
+// First-order CS Greeks: fused axes kernel vs one complex pricing per input
+
+void bench_cs_first_order() {
+    cout << "\n=== First-order CS Greeks: per-input complex pricings vs fused kernel ===" << endl;
+    using C = complex<double>;
+    const size_t n = 4096;
+    mt19937_64 rng(7);
+    uniform_real_distribution<double> u(0.0, 1.0);
+    vector<double> S(n), K(n), r(n), q(n), sigma(n), T(n);
+    for (size_t i = 0; i < n; ++i) {
+        S[i] = 100.0; K[i] = 60.0 + 80.0 * u(rng); r[i] = 0.05 * u(rng); q[i] = 0.03 * u(rng);
+        sigma[i] = 0.05 + 0.5 * u(rng); T[i] = 0.05 + 3.0 * u(rng);
+    }
+    const double h = 1e-20;
+    const int reps = 20;
+
+    vector<FirstOrderGreeks> ref(n), fused(n);
+    double t0 = now_seconds();
+    for (int k = 0; k < reps; ++k)
+        for (size_t i = 0; i < n; ++i) {
+            FirstOrderGreeks& g = ref[i];
+            g.delta        = bs_price_call_t<C>(C(S[i], h), K[i], r[i], q[i], sigma[i], T[i]).imag() / h;
+            g.vega         = bs_price_call_t<C>(S[i], K[i], r[i], q[i], C(sigma[i], h), T[i]).imag() / h;
+            g.rho          = bs_price_call_t<C>(S[i], K[i], C(r[i], h), q[i], sigma[i], T[i]).imag() / h;
+            g.dividend_rho = bs_price_call_t<C>(S[i], K[i], r[i], C(q[i], h), sigma[i], T[i]).imag() / h;
+            g.theta        = -bs_price_call_t<C>(S[i], K[i], r[i], q[i], sigma[i], C(T[i], h)).imag() / h;
+        }
+    double t1 = now_seconds();
+    for (int k = 0; k < reps; ++k)
+        compute_cs_first_order_batch(S.data(), K.data(), r.data(), q.data(), sigma.data(), T.data(),
+                                     fused.data(), n, h);
+    double t2 = now_seconds();
+
+    // |fused - analytic| <= atol + rtol·|analytic|: deep out-of-the-money Greeks are tiny,
+    // where a relative error alone would flag rounding in the last digit.
+    const double atol = 1e-12, rtol = 1e-10;
+    double worst = 0.0, worst_ref = 0.0;
+    size_t within = 0, exact = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const FirstOrderGreeks a = compute_analytic_first_order(S[i], K[i], r[i], q[i], sigma[i], T[i]);
+        const double f[] = {fused[i].delta, fused[i].vega, fused[i].rho, fused[i].dividend_rho, fused[i].theta};
+        const double t[] = {ref[i].delta, ref[i].vega, ref[i].rho, ref[i].dividend_rho, ref[i].theta};
+        const double m[] = {a.delta, a.vega, a.rho, a.dividend_rho, a.theta};
+        for (int j = 0; j < 5; ++j) {
+            const double e = abs(f[j] - m[j]) / (atol + rtol * abs(m[j]));
+            worst = max(worst, e);
+            within += e <= 1.0;
+            worst_ref = max(worst_ref, abs(f[j] - t[j]) / (atol + rtol * abs(t[j])));
+            exact += f[j] == m[j];
+        }
+    }
+    cout << "  " << n << " options: 5 complex pricings=" << (t1 - t0) / reps * 1e3 << "ms  fused="
+         << (t2 - t1) / reps * 1e3 << "ms  (" << (t1 - t0) / (t2 - t1) << "x)" << endl;
+    cout << "  fused vs analytic (atol " << atol << ", rtol " << rtol << "): " << within << " of " << 5 * n
+         << " within, worst " << worst << " of tolerance, " << exact << " bit-equal; vs per-input complex pricing: worst "
+         << worst_ref << " of tolerance" << endl;
+}
+
+// Hand-written adjoint vs price-only batch, checked against complex step
+
+void bench_adjoint() {
+    cout << "\n=== Adjoint: price + 6 sensitivities vs price only ===" << endl;
+    using C = complex<double>;
+    const size_t n = 4096;
+    mt19937_64 rng(11);
+    uniform_real_distribution<double> u(0.0, 1.0);
+    vector<double> S(n), K(n), r(n), q(n), sigma(n), T(n);
+    for (size_t i = 0; i < n; ++i) {
+        S[i] = 100.0; K[i] = 60.0 + 80.0 * u(rng); r[i] = 0.05 * u(rng); q[i] = 0.03 * u(rng);
+        sigma[i] = 0.05 + 0.5 * u(rng); T[i] = 0.05 + 3.0 * u(rng);
+    }
+    vector<double> price(n), adj_price(n), dS(n), dK(n), dr(n), dq(n), dsigma(n), dT(n);
+    const int reps = 50;
+
+    double t0 = now_seconds();
+    for (int k = 0; k < reps; ++k)
+        quant::bs_price_call_batch(S.data(), K.data(), r.data(), q.data(), sigma.data(), T.data(), price.data(), n);
+    double t1 = now_seconds();
+    for (int k = 0; k < reps; ++k)
+        quant::bs_price_call_adjoint_batch(S.data(), K.data(), r.data(), q.data(), sigma.data(), T.data(),
+                                    adj_price.data(), dS.data(), dK.data(), dr.data(), dq.data(),
+                                    dsigma.data(), dT.data(), n);
+    double t2 = now_seconds();
+
+    // Complex-step reference, one pricing per input
+    const double h = 1e-20;
+    double rel = 0.0, price_diff = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double cs[6] = {
+            bs_price_call_t<C>(C(S[i], h), K[i], r[i], q[i], sigma[i], T[i]).imag() / h,
+            bs_price_call_t<C>(S[i], C(K[i], h), r[i], q[i], sigma[i], T[i]).imag() / h,
+            bs_price_call_t<C>(S[i], K[i], C(r[i], h), q[i], sigma[i], T[i]).imag() / h,
+            bs_price_call_t<C>(S[i], K[i], r[i], C(q[i], h), sigma[i], T[i]).imag() / h,
+            bs_price_call_t<C>(S[i], K[i], r[i], q[i], C(sigma[i], h), T[i]).imag() / h,
+            bs_price_call_t<C>(S[i], K[i], r[i], q[i], sigma[i], C(T[i], h)).imag() / h};
+        const double ad[6] = {dS[i], dK[i], dr[i], dq[i], dsigma[i], dT[i]};
+        for (int j = 0; j < 6; ++j) rel = max(rel, abs(ad[j] - cs[j]) / max(abs(cs[j]), 1e-12));
+        price_diff = max(price_diff, abs(adj_price[i] - bs_price_call(S[i], K[i], r[i], q[i], sigma[i], T[i])));
+    }
+    cout << "  " << n << " options: price=" << (t1 - t0) / reps * 1e3 << "ms  price+gradient="
+         << (t2 - t1) / reps * 1e3 << "ms  (" << (t2 - t1) / (t1 - t0) << "x price)" << endl;
+    cout << "  max rel diff vs complex step=" << rel << "  max|price - bs_price_call|=" << price_diff << endl;
+}
+
+// Inverse normal with 1/φ(z) for pathwise MC AAD
+
+void bench_icn_derivative() {
+#ifdef ICN_ENABLE_HALLEY_REFINEMENT
+    cout << "\n=== Inverse normal: value + 1/phi(z), two passes vs one call (Halley, phi reused) ===" << endl;
+#else
+    cout << "\n=== Inverse normal: value + 1/phi(z), two passes vs one call ===" << endl;
+#endif
+    const size_t n = 4096;
+    vector<double> x(n), z(n), inv(n), z2(n), dz(n);
+    for (size_t i = 0; i < n; ++i) x[i] = (i + 0.5) / n;
+    const quant::InverseCumulativeNormal icn;
+    const int reps = 5;
+
+    double t0 = now_seconds();
+    for (int k = 0; k < reps; ++k) {
+        icn(x.data(), z.data(), n);
+        for (size_t i = 0; i < n; ++i) inv[i] = 1.0 / phi(z[i]);
+    }
+    double t1 = now_seconds();
+    for (int k = 0; k < reps; ++k) icn(x.data(), z2.data(), dz.data(), n);
+    double t2 = now_seconds();
+
+    // dz/dx against a central difference of the inverse itself
+    double z_diff = 0.0, rel = 0.0, fd_rel = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        z_diff = max(z_diff, abs(z2[i] - z[i]));
+        rel = max(rel, abs(dz[i] - inv[i]) / inv[i]);
+        const double hx = 1e-6 * min(x[i], 1.0 - x[i]);
+        const double fd = (icn(x[i] + hx) - icn(x[i] - hx)) / (2.0 * hx);
+        fd_rel = max(fd_rel, abs(dz[i] - fd) / dz[i]);
+    }
+    cout << "  " << n << " points: two passes=" << (t1 - t0) / reps * 1e3 << "ms  one call="
+         << (t2 - t1) / reps * 1e3 << "ms  max|dz|=" << z_diff << "  max rel diff vs 1/phi(z)=" << rel
+         << "  vs central diff=" << fd_rel << endl;
+}
+
+// Small-σ√T series regime vs the erfc form
+
+void bench_small_vol_regime() {
+    cout << "\n=== Small sigma*sqrt(T): series regime vs erfc form ===" << endl;
+    const size_t n = 4096;
+    mt19937_64 rng(13);
+    uniform_real_distribution<double> u(0.0, 1.0);
+    vector<double> S(n, 100.0), K(n), r(n, 0.0), q(n, 0.0), sigma(n), T(n), out(n);
+    for (size_t i = 0; i < n; ++i) {
+        sigma[i] = 0.005 + 0.1 * u(rng);
+        T[i] = (0.5 + 20.0 * u(rng)) / 365.0;
+        K[i] = 100.0 * exp((2.0 * u(rng) - 1.0) * 0.9 * sigma[i] * sqrt(T[i]));   // within the regime
+    }
+    // The erfc form bs_price_call used before the regime split
+    auto erfc_form = [](double S, double K, double r, double q, double sigma, double T) {
+        const double DF = exp(-r * T), F = S * exp((r - q) * T), sT = sigma * sqrt(T);
+        const double d1 = (log(F / K) + 0.5 * sigma * sigma * T) / sT;
+        return DF * (F * Phi_real(d1) - K * Phi_real(d1 - sT));
+    };
+    // Best of five trials each: single runs on a shared core vary by ±20%.
+    const int reps = 200;
+    double sink = 0.0;
+    double t_erfc = 1e300, t_series = 1e300, t_batch = 1e300;
+    for (int trial = 0; trial < 5; ++trial) {
+        double t0 = now_seconds();
+        for (int k = 0; k < reps; ++k)
+            for (size_t i = 0; i < n; ++i) sink += erfc_form(S[i], K[i], r[i], q[i], sigma[i], T[i]);
+        double t1 = now_seconds();
+        for (int k = 0; k < reps; ++k)
+            for (size_t i = 0; i < n; ++i) sink += bs_price_call(S[i], K[i], r[i], q[i], sigma[i], T[i]);
+        double t2 = now_seconds();
+        for (int k = 0; k < reps; ++k)
+            quant::bs_price_call_batch(S.data(), K.data(), r.data(), q.data(), sigma.data(), T.data(), out.data(), n);
+        double t3 = now_seconds();
+        t_erfc = min(t_erfc, (t1 - t0) / reps);
+        t_series = min(t_series, (t2 - t1) / reps);
+        t_batch = min(t_batch, (t3 - t2) / reps);
+    }
+
+    // Accuracy at scenario 2 against a long-double reference on the same F, K, σ√T
+    const double s2 = 0.01 * sqrt(1.0 / 365.0);
+    const long double ref = 100.0L * erfl(0.5L * s2 / sqrtl(2.0L));   // ATM: F(Φ(s/2) - Φ(-s/2))
+    cout << "  " << n << " in-regime options: erfc form=" << t_erfc * 1e3 << "ms  series="
+         << t_series * 1e3 << "ms  (speed " << t_erfc / t_series << "x)  batch="
+         << t_batch * 1e3 << "ms" << (sink == 0.0 ? " " : "") << endl;
+    cout << "  scenario 2 ATM rel error: erfc form="
+         << abs((long double)erfc_form(100.0, 100.0, 0.0, 0.0, 0.01, 1.0 / 365.0) - ref) / ref << "  series="
+         << abs((long double)bs_price_call(100.0, 100.0, 0.0, 0.0, 0.01, 1.0 / 365.0) - ref) / ref << endl;
+}
+
+// Normalised Black core, regime-partitioned batch
+
+void bench_normalised_black() {
+    cout << "\n=== Normalised Black: regime-partitioned batch vs bs_price_call_batch ===" << endl;
+    const size_t n = 1 << 14;
+    mt19937_64 rng(17);
+    uniform_real_distribution<double> u(0.0, 1.0);
+    vector<double> S(n, 100.0), K(n), r(n), q(n), sigma(n), T(n), a(n), b(n);
+    size_t counts[quant::black_regime_count] = {};
+    for (size_t i = 0; i < n; ++i) {
+        // Mixed book: short-dated ATM, long-dated, deep OTM wings, a few expired
+        r[i] = 0.03 * u(rng); q[i] = 0.02 * u(rng);
+        switch (i % 4) {
+        case 0:  sigma[i] = 0.01 + 0.1 * u(rng); T[i] = (1.0 + 10.0 * u(rng)) / 365.0; break;
+        case 1:  sigma[i] = 0.1 + 0.4 * u(rng);  T[i] = 0.25 + 5.0 * u(rng); break;
+        default: sigma[i] = 0.05 + 0.3 * u(rng); T[i] = 0.05 + 2.0 * u(rng); break;
+        }
+        if (i % 101 == 0) T[i] = 0.0;
+        const double sT = sigma[i] * sqrt(T[i]);
+        const double wing = (i % 4 == 3) ? 9.0 + 6.0 * u(rng) : 2.0 * u(rng) - 1.0;
+        K[i] = S[i] * exp((r[i] - q[i]) * T[i] + wing * max(sT, 0.01));
+        const double F = S[i] * exp((r[i] - q[i]) * T[i]);
+        counts[static_cast<size_t>(quant::black_regime(log(F / K[i]), sT))]++;
+    }
+    // Shuffle so regimes are interleaved
+    for (size_t i = n - 1; i > 0; --i) {
+        const size_t j = rng() % (i + 1);
+        swap(K[i], K[j]); swap(r[i], r[j]); swap(q[i], q[j]); swap(sigma[i], sigma[j]); swap(T[i], T[j]);
+    }
+
+    // Best of five trials each: single runs on a shared core vary by ±20%.
+    const int reps = 20;
+    double t_bs = 1e300, t_nb = 1e300;
+    for (int trial = 0; trial < 5; ++trial) {
+        double t0 = now_seconds();
+        for (int k = 0; k < reps; ++k)
+            quant::bs_price_call_batch(S.data(), K.data(), r.data(), q.data(), sigma.data(), T.data(), a.data(), n);
+        double t1 = now_seconds();
+        for (int k = 0; k < reps; ++k)
+            quant::black_price_call_batch(S.data(), K.data(), r.data(), q.data(), sigma.data(), T.data(), b.data(), n);
+        double t2 = now_seconds();
+        t_bs = min(t_bs, (t1 - t0) / reps);
+        t_nb = min(t_nb, (t2 - t1) / reps);
+    }
+
+    double rel = 0.0;
+    for (size_t i = 0; i < n; ++i)
+        if (a[i] > 1e-12 * S[i]) rel = max(rel, abs(b[i] - a[i]) / a[i]);
+    cout << "  regimes: intrinsic=" << counts[0] << " small-vol=" << counts[1] << " tail=" << counts[2]
+         << " general=" << counts[3] << endl;
+    cout << "  " << n << " options: bs_price_call_batch=" << t_bs * 1e3 << "ms  normalised="
+         << t_nb * 1e3 << "ms  (" << t_bs / t_nb << "x)  max rel diff (C > 1e-12 S)="
+         << rel << endl;
+}
+
+// Spot x vol ladders: per-cell scalar calls vs ladder engine
+
+void bench_ladder() {
+    cout << "\n=== Greeks ladder (50 spots x 20 vols): per-cell calls vs ladder engine ===" << endl;
+    quant::LadderGrid grid;
+    for (int i = 0; i < 50; ++i) grid.spot_shift.push_back(-0.25 + 0.5 * i / 49.0);
+    for (int j = 0; j < 20; ++j) grid.vol_shift.push_back(-0.05 + 0.1 * j / 19.0);
+
+    const size_t n = 500;
+    mt19937_64 rng(19);
+    uniform_real_distribution<double> u(0.0, 1.0);
+    vector<quant::BSInput> book(n);
+    vector<double> qty(n);
+    for (size_t i = 0; i < n; ++i) {
+        book[i] = {100.0, 70.0 + 60.0 * u(rng), 0.03, 0.01, 0.1 + 0.3 * u(rng), 0.02 + 2.0 * u(rng)};
+        qty[i] = u(rng) < 0.5 ? -1.0 : 1.0;
+    }
+
+    // Reference: scalar calls per cell
+    quant::Ladder ref;
+    ref.resize(grid.spot_shift.size(), grid.vol_shift.size());
+    double t0 = now_seconds();
+    for (size_t k = 0; k < n; ++k) {
+        const quant::BSInput& o = book[k];
+        for (size_t v = 0; v < ref.n_vol; ++v)
+            for (size_t s = 0; s < ref.n_spot; ++s) {
+                const double S = o.S * (1.0 + grid.spot_shift[s]), sig = o.sigma + grid.vol_shift[v];
+                const AnalyticGreeks g = compute_analytic_greeks(S, o.K, o.r, o.q, sig, o.T);
+                const FirstOrderGreeks f = compute_analytic_first_order(S, o.K, o.r, o.q, sig, o.T);
+                const size_t c = v * ref.n_spot + s;
+                ref.price[c] += qty[k] * bs_price_call(S, o.K, o.r, o.q, sig, o.T);
+                ref.delta[c] += qty[k] * g.delta;
+                ref.gamma[c] += qty[k] * g.gamma;
+                ref.vega[c]  += qty[k] * f.vega;
+                ref.theta[c] += qty[k] * f.theta;
+            }
+    }
+    double t1 = now_seconds();
+    quant::Ladder lad;
+    quant::bs_book_ladder(book.data(), qty.data(), n, grid, lad);
+    double t2 = now_seconds();
+
+    double diff = 0.0;
+    for (size_t c = 0; c < lad.price.size(); ++c)
+        diff = max({diff, abs(lad.price[c] - ref.price[c]), abs(lad.delta[c] - ref.delta[c]),
+                    abs(lad.gamma[c] - ref.gamma[c]), abs(lad.vega[c] - ref.vega[c]) / 100.0,
+                    abs(lad.theta[c] - ref.theta[c]) / 10.0});
+    cout << "  book of " << n << " positions: per-cell=" << (t1 - t0) * 1e3 << "ms  ladder="
+         << (t2 - t1) * 1e3 << "ms  (" << (t1 - t0) / (t2 - t1) << "x)  max scaled |diff|=" << diff << endl;
+}
+
+// AoSoA option book vs array of records
+
+void bench_option_book() {
+    cout << "\n=== Option book: AoSoA hot/cold split vs array of records ===" << endl;
+    struct Record {               // a typical AoS trade record
+        string id, underlying;
+        double quantity;
+        double S, K, r, q, sigma, T;
+    };
+    const size_t n = size_t(1) << 20;
+    mt19937_64 rng(23);
+    uniform_real_distribution<double> u(0.0, 1.0);
+    vector<Record> records(n);
+    quant::OptionBook book;
+    book.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        Record& rec = records[i];
+        rec = {"TRD-" + to_string(1000000 + i), "UND" + to_string(i % 97), 1.0,
+               100.0, 60.0 + 80.0 * u(rng), 0.03, 0.01, 0.1 + 0.3 * u(rng), 0.05 + 2.0 * u(rng)};
+        book.push_back({rec.S, rec.K, rec.r, rec.q, rec.sigma, rec.T}, {rec.id, rec.underlying, rec.quantity});
+    }
+
+    // Bandwidth-bound scan: plain sums of S, K, σ and T. Both layouts accumulate per lane
+    // (i mod 8), so the sums agree bit for bit and the block loop needs no reassociation.
+    const int reps = 10;
+    double acc_a[4][quant::book_lanes] = {}, acc_b[4][quant::book_lanes] = {};
+    double t0 = now_seconds();
+    for (int k = 0; k < reps; ++k)
+        for (size_t i = 0; i < n; ++i) {
+            const Record& rec = records[i];
+            const size_t l = i % quant::book_lanes;
+            acc_a[0][l] += rec.S;
+            acc_a[1][l] += rec.K;
+            acc_a[2][l] += rec.sigma;
+            acc_a[3][l] += rec.T;
+        }
+    double t1 = now_seconds();
+    for (int k = 0; k < reps; ++k)
+        for (const quant::BlockView v : book)
+            for (size_t l = 0; l < v.lanes; ++l) {
+                acc_b[0][l] += v.S[l];
+                acc_b[1][l] += v.K[l];
+                acc_b[2][l] += v.sigma[l];
+                acc_b[3][l] += v.T[l];
+            }
+    double t2 = now_seconds();
+    const bool same_sums = memcmp(acc_a, acc_b, sizeof(acc_a)) == 0;
+
+    // Pricing: gather records into SoA vs price the blocks in place
+    vector<double> S(n), K(n), r(n), q(n), sigma(n), T(n), pa(n), pb(n);
+    double t3 = now_seconds();
+    for (size_t i = 0; i < n; ++i) {
+        const Record& rec = records[i];
+        S[i] = rec.S; K[i] = rec.K; r[i] = rec.r; q[i] = rec.q; sigma[i] = rec.sigma; T[i] = rec.T;
+    }
+    quant::bs_price_call_batch(S.data(), K.data(), r.data(), q.data(), sigma.data(), T.data(), pa.data(), n);
+    double t4 = now_seconds();
+    quant::book_price_call(book, pb.data());
+    double t5 = now_seconds();
+
+    double diff = 0.0;
+    for (size_t i = 0; i < n; ++i) diff = max(diff, abs(pa[i] - pb[i]));
+    const double gb = 4.0 * sizeof(double) * n * reps / 1e9;   // useful bytes: S, K, σ, T
+    cout << "  " << n << " options, scan: records=" << (t1 - t0) / reps * 1e3 << "ms ("
+         << gb / (t1 - t0) << " GB/s useful)  AoSoA=" << (t2 - t1) / reps * 1e3 << "ms ("
+         << gb / (t2 - t1) << " GB/s)  same=" << (same_sums ? "yes" : "no") << endl;
+    cout << "  pricing: gather+batch=" << (t4 - t3) * 1e3 << "ms  in-place blocks=" << (t5 - t4) * 1e3
+         << "ms  max|diff|=" << diff << endl;
+}
+
+// Huge Pages
+void bench_huge_pages() {
+    cout << "\n=== Huge pages: SoA batch arrays on 4K vs 2MB pages ===" << endl;
+    const size_t n = size_t(1) << 22;          // 32 MB per array
+    const size_t n_gather = size_t(1) << 24;
+    vector<uint32_t> idx(n_gather);
+    mt19937_64 rng(29);
+    for (uint32_t& i : idx) i = static_cast<uint32_t>(rng() % n);
+    quant::TlbMissCounter tlb;
+    if (!tlb.available()) cout << "  (dTLB counter unavailable: perf_event_open refused)" << endl;
+
+    for (quant::PagePolicy policy : {quant::PagePolicy::Small, quant::PagePolicy::Transparent,
+                                     quant::PagePolicy::Explicit}) {
+        using buf = quant::huge_vector<double>;
+        const quant::HugePageAllocator<double> alloc(policy);
+        const quant::PageFaultStats f0 = quant::page_fault_snapshot();
+        double t0 = now_seconds();
+        buf S(n, 100.0, alloc), K(n, alloc), r(n, 0.03, alloc), q(n, 0.01, alloc), sigma(n, alloc), T(n, alloc);
+        buf out(n, alloc);
+        for (size_t i = 0; i < n; ++i) {
+            K[i] = 60.0 + 80.0 * (i % 1024) / 1024.0;
+            sigma[i] = 0.1 + 0.3 * (i % 613) / 613.0;
+            T[i] = 0.05 + 2.0 * (i % 409) / 409.0;
+        }
+        quant::prefault(out.data(), n * sizeof(double));
+        double t1 = now_seconds();
+        const quant::PageFaultStats faults = quant::page_fault_snapshot() - f0;
+
+        // Streaming: the batch pricer over all arrays
+        const quant::PageFaultStats f1 = quant::page_fault_snapshot();
+        double t2 = now_seconds();
+        quant::bs_price_call_batch(S.data(), K.data(), r.data(), q.data(), sigma.data(), T.data(), out.data(), n);
+        double t3 = now_seconds();
+        const long timed_faults = (quant::page_fault_snapshot() - f1).minor;
+
+        // Random access: gather K·σ²·T at scattered indices (TLB-bound on 4K pages)
+        double sink = 0.0;
+        tlb.start();
+        double t4 = now_seconds();
+        for (uint32_t i : idx) sink += K[i] * sigma[i] * sigma[i] * T[i];
+        double t5 = now_seconds();
+        const uint64_t misses = tlb.stop();
+
+        // What the kernel gave, not what was asked for: hugetlb without a pool is THP, and THP
+        // without transparent_hugepage=madvise|always is 4K pages.
+        const string pages = string(quant::page_policy_name(policy)) + "->"
+                           + quant::page_policy_name(quant::backed_page_policy(S.data()));
+        cout << "  " << setw(12) << pages << ": alloc+touch " << (t1 - t0) * 1e3
+             << "ms, " << faults.minor << " minor/" << faults.major << " major faults;  batch "
+             << (t3 - t2) * 1e3 << "ms (" << timed_faults << " faults in timed region);  gather "
+             << (t5 - t4) / n_gather * 1e9 << "ns/elem";
+        if (tlb.available()) cout << ", " << double(misses) / n_gather << " dTLB misses/elem";
+        cout << "  [" << sink << "]" << endl;
+    }
+    cout << "  (requested->obtained backing, from /proc/self/smaps)" << endl;
+}
+
+// Task Scheduler
+void bench_task_scheduler() {
+    cout << "\n=== Task scheduler: work stealing vs thread-per-call ===" << endl;
+    quant::TaskScheduler& pool = quant::TaskScheduler::global();
+    cout << "  global pool: " << pool.size() << " thread(s) incl. caller" << endl;
+
+    // Fork/join overhead: many small parallel regions
+    const int rounds = 2000;
+    const size_t parts = 8;
+    vector<double> acc(parts, 0.0);
+    auto work = [&](size_t p) { for (int k = 0; k < 200; ++k) acc[p] += sqrt(double(k + p)); };
+    double t0 = now_seconds();
+    for (int r = 0; r < rounds; ++r) {
+        vector<thread> ts;
+        for (size_t p = 0; p < parts; ++p) ts.emplace_back(work, p);
+        for (auto& t : ts) t.join();
+    }
+    double t1 = now_seconds();
+    for (int r = 0; r < rounds; ++r)
+        quant::parallel_for(0, parts, 1, [&](size_t lo, size_t hi) { for (size_t p = lo; p < hi; ++p) work(p); });
+    double t2 = now_seconds();
+    cout << "  " << rounds << " regions x " << parts << " tasks: std::thread " << (t1 - t0) / rounds * 1e6
+         << "us/region  scheduler " << (t2 - t1) / rounds * 1e6 << "us/region" << endl;
+
+    // parallel_reduce over a priced book: the sum does not depend on the pool size
+    const size_t n = size_t(1) << 20;
+    vector<double> S(n, 100.0), K(n), r(n, 0.03), q(n, 0.01), sigma(n), T(n), price(n);
+    for (size_t i = 0; i < n; ++i) {
+        K[i] = 60.0 + 80.0 * (i % 1024) / 1024.0;
+        sigma[i] = 0.1 + 0.3 * (i % 613) / 613.0;
+        T[i] = 0.05 + 2.0 * (i % 409) / 409.0;
+    }
+    auto book_value = [&](quant::TaskScheduler& s) {
+        return quant::parallel_reduce(size_t(0), n, size_t(8192), 0.0, [&](size_t lo, size_t hi) {
+            quant::bs_price_call_batch(&S[lo], &K[lo], &r[lo], &q[lo], &sigma[lo], &T[lo], &price[lo], hi - lo);
+            double v = 0.0;
+            for (size_t i = lo; i < hi; ++i) v += price[i];
+            return v;
+        }, [](double a, double b) { return a + b; }, s);
+    };
+    double t3 = now_seconds();
+    const double v_global = book_value(pool);
+    double t4 = now_seconds();
+    quant::TaskScheduler pool4(4);
+    const double v4 = book_value(pool4);
+    cout << "  book value (" << n << " options, grain 8192): " << v_global << " in " << (t4 - t3) * 1e3
+         << "ms;  4-thread pool gives the same sum: " << (v_global == v4 ? "yes" : "no") << endl;
+
+    // Nested: MC runs inside a parallel loop over positions share the one pool
+    const double strikes[] = {80.0, 90.0, 100.0, 110.0, 120.0, 130.0};
+    const size_t n_pos = sizeof(strikes) / sizeof(strikes[0]);
+    quant::MCConfig cfg;
+    cfg.max_paths = size_t(1) << 17;
+    vector<double> nested(n_pos), serial(n_pos);
+    auto price_pos = [&](size_t k) {
+        const EuropeanCallPayoff call{100.0, strikes[k], 0.02, 0.0, 0.2, 1.0};
+        return quant::mc_run(cfg, [&](uint64_t seed, double* payoff, size_t m) {
+            quant::fill_normals(seed, payoff, m);
+            for (size_t i = 0; i < m; ++i) payoff[i] = call(&payoff[i], 1);
+        }).mean;
+    };
+    double t5 = now_seconds();
+    quant::parallel_for(0, n_pos, 1, [&](size_t lo, size_t hi) { for (size_t k = lo; k < hi; ++k) nested[k] = price_pos(k); });
+    double t6 = now_seconds();
+    for (size_t k = 0; k < n_pos; ++k) serial[k] = price_pos(k);
+    double t7 = now_seconds();
+    cout << "  nested MC (" << n_pos << " positions x " << cfg.max_paths << " paths): nested "
+         << (t6 - t5) * 1e3 << "ms  one-by-one " << (t7 - t6) * 1e3 << "ms  identical="
+         << (nested == serial ? "yes" : "no") << endl;
+}
+
+// Risk-Run Task Graph
+void bench_task_graph() {
+    cout << "\n=== Task graph: curves -> implied vols -> prices/Greeks -> aggregates ===" << endl;
+    struct Underlier {
+        double S;
+        vector<double> K, T, quote, qty;          // market data
+        vector<double> r, q, vol, price, delta, vega;  // stage outputs
+        double pv = 0.0, net_delta = 0.0, net_vega = 0.0;
+    };
+    const size_t n_und = 12;
+    mt19937_64 rng(31);
+    uniform_real_distribution<double> u(0.0, 1.0);
+    vector<Underlier> book(n_und);
+    size_t n_opt = 0;
+    for (size_t k = 0; k < n_und; ++k) {
+        Underlier& U = book[k];
+        const size_t m = size_t(512) << (k % 4);    // uneven: 512 .. 4096 options
+        U.S = 50.0 + 10.0 * k;
+        for (size_t i = 0; i < m; ++i) {
+            const double K = U.S * (0.7 + 0.6 * u(rng)), T = 0.1 + 2.0 * u(rng);
+            const double true_vol = 0.15 + 0.1 * abs(log(K / U.S)) + 0.02 * k / n_und;
+            const double r = 0.02 + 0.01 * (1.0 - exp(-T));
+            U.K.push_back(K);
+            U.T.push_back(T);
+            U.quote.push_back(bs_price_call(U.S, K, r, 0.01, true_vol, T));
+            U.qty.push_back(u(rng) < 0.5 ? -1.0 : 2.0);
+        }
+        n_opt += m;
+    }
+
+    // Stages
+    auto curve = [&](Underlier& U) {
+        const size_t m = U.K.size();
+        U.r.resize(m); U.q.assign(m, 0.01);
+        for (size_t i = 0; i < m; ++i) U.r[i] = 0.02 + 0.01 * (1.0 - exp(-U.T[i]));
+    };
+    auto vols = [&](Underlier& U) {
+        const size_t m = U.K.size();
+        const vector<double> S(m, U.S);
+        U.vol.resize(m);
+        quant::black_implied_vol_call_batch(U.quote.data(), S.data(), U.K.data(), U.r.data(), U.q.data(), U.T.data(),
+                                            U.vol.data(), m);
+    };
+    auto greeks = [&](Underlier& U) {
+        const size_t m = U.K.size();
+        const vector<double> S(m, U.S);
+        vector<double> dK(m), dr(m), dq(m), dT(m);
+        U.price.resize(m); U.delta.resize(m); U.vega.resize(m);
+        quant::bs_price_call_adjoint_batch(S.data(), U.K.data(), U.r.data(), U.q.data(), U.vol.data(), U.T.data(),
+                                           U.price.data(), U.delta.data(), dK.data(), dr.data(), dq.data(),
+                                           U.vega.data(), dT.data(), m);
+    };
+    auto aggregate = [&](Underlier& U) {
+        U.pv = U.net_delta = U.net_vega = 0.0;
+        for (size_t i = 0; i < U.K.size(); ++i) {
+            U.pv += U.qty[i] * U.price[i];
+            U.net_delta += U.qty[i] * U.delta[i];
+            U.net_vega += U.qty[i] * U.vega[i];
+        }
+    };
+    double total_pv = 0.0;
+    auto total = [&] {
+        total_pv = 0.0;
+        for (const Underlier& U : book) total_pv += U.pv;
+    };
+
+    // Staged: a parallel_for per stage, barrier in between
+    double t0 = now_seconds();
+    quant::parallel_for(0, n_und, 1, [&](size_t lo, size_t hi) { for (size_t k = lo; k < hi; ++k) curve(book[k]); });
+    quant::parallel_for(0, n_und, 1, [&](size_t lo, size_t hi) { for (size_t k = lo; k < hi; ++k) vols(book[k]); });
+    quant::parallel_for(0, n_und, 1, [&](size_t lo, size_t hi) { for (size_t k = lo; k < hi; ++k) greeks(book[k]); });
+    quant::parallel_for(0, n_und, 1, [&](size_t lo, size_t hi) { for (size_t k = lo; k < hi; ++k) aggregate(book[k]); });
+    total();
+    double t1 = now_seconds();
+    const double staged_pv = total_pv;
+
+    // Graph: per-underlier chains, one sink
+    quant::TaskGraph g;
+    vector<quant::TaskGraph::NodeId> sinks;
+    for (size_t k = 0; k < n_und; ++k) {
+        Underlier& U = book[k];
+        const string tag = to_string(k);
+        const auto c = g.add("curve:" + tag, [&] { curve(U); });
+        const auto v = g.add("vols:" + tag, [&] { vols(U); }, {c});
+        const auto p = g.add("greeks:" + tag, [&] { greeks(U); }, {v});
+        sinks.push_back(g.add("aggregate:" + tag, [&] { aggregate(U); }, {p}));
+    }
+    g.add("book", total, sinks);
+    double t2 = now_seconds();
+    g.run();
+    double t3 = now_seconds();
+
+    double vol_err = 0.0;
+    for (size_t k = 0; k < n_und; ++k)
+        for (size_t i = 0; i < book[k].K.size(); ++i)
+            vol_err = max(vol_err, abs(book[k].vol[i] - (0.15 + 0.1 * abs(log(book[k].K[i] / book[k].S)) + 0.02 * k / n_und)));
+
+    const vector<quant::TaskGraph::NodeId> path = g.critical_path();
+    double path_len = 0.0;
+    for (auto i : path) path_len += g.timings()[i].duration();
+    cout << "  " << n_und << " underliers, " << n_opt << " options, pool " << quant::TaskScheduler::global().size()
+         << " thread(s): staged " << (t1 - t0) * 1e3 << "ms  graph " << (t3 - t2) * 1e3 << "ms  PV "
+         << total_pv << (total_pv == staged_pv ? " (same)" : " (DIFFERS)") << "  max|iv err|=" << vol_err << endl;
+    cout << "  work " << g.total_work() * 1e3 << "ms, makespan " << g.makespan() * 1e3 << "ms, critical path "
+         << path_len * 1e3 << "ms (parallelism bound " << g.total_work() / path_len << "x):";
+    for (auto i : path) cout << " " << g.name(i);
+    cout << endl;
+    ofstream csv("risk_run_timing.csv");
+    g.write_timing_csv(csv);
+    cout << "  per-node timing -> risk_run_timing.csv" << endl;
+}
+
+// Streaming Pipeline
+void bench_stream_pipeline() {
+    cout << "\n=== Streaming pipeline: mmap read -> price -> write, bounded memory ===" << endl;
+    const size_t n = size_t(1) << 21;
+    const string dir = std::filesystem::temp_directory_path().string();
+    const string in_path = dir + "/bs_stream_in.bin", out_a = dir + "/bs_stream_a.bin", out_b = dir + "/bs_stream_b.bin";
+    {
+        mt19937_64 rng(37);
+        uniform_real_distribution<double> u(0.0, 1.0);
+        vector<double> rec(6 * n);
+        for (size_t i = 0; i < n; ++i) {
+            const double r[6] = {100.0, 60.0 + 80.0 * u(rng), 0.03, 0.01, 0.1 + 0.3 * u(rng), 0.05 + 2.0 * u(rng)};
+            copy(r, r + 6, &rec[6 * i]);
+        }
+        ofstream f(in_path, ios::binary);
+        f.write(reinterpret_cast<const char*>(rec.data()), rec.size() * sizeof(double));
+    }
+
+    // Load everything, price, write: memory grows with the file
+    double t0 = now_seconds();
+    {
+        ifstream f(in_path, ios::binary);
+        vector<double> rec(6 * n);
+        f.read(reinterpret_cast<char*>(rec.data()), rec.size() * sizeof(double));
+        vector<double> S(n), K(n), r(n), q(n), sigma(n), T(n), price(n);
+        for (size_t i = 0; i < n; ++i) {
+            S[i] = rec[6 * i]; K[i] = rec[6 * i + 1]; r[i] = rec[6 * i + 2];
+            q[i] = rec[6 * i + 3]; sigma[i] = rec[6 * i + 4]; T[i] = rec[6 * i + 5];
+        }
+        quant::bs_price_call_batch(S.data(), K.data(), r.data(), q.data(), sigma.data(), T.data(), price.data(), n);
+        ofstream o(out_a, ios::binary);
+        o.write(reinterpret_cast<const char*>(price.data()), n * sizeof(double));
+    }
+    double t1 = now_seconds();
+
+    quant::StreamConfig cfg;
+    const quant::StreamStats st = quant::price_file(in_path, out_b, cfg);
+    double t2 = now_seconds();
+
+    ifstream fa(out_a, ios::binary), fb(out_b, ios::binary);
+    const bool same = equal(istreambuf_iterator<char>(fa), istreambuf_iterator<char>(), istreambuf_iterator<char>(fb),
+                            istreambuf_iterator<char>());
+    const double mb = 7.0 * sizeof(double) * n / 1e6;   // bytes in + out
+    cout << "  " << n << " options (" << 6.0 * sizeof(double) * n / 1e6 << " MB in): load-all "
+         << (t1 - t0) * 1e3 << "ms (" << mb / (t1 - t0) << " MB/s, working set ~" << 13.0 * sizeof(double) * n / 1e6
+         << " MB)" << endl;
+    cout << "  pipeline " << (t2 - t1) * 1e3 << "ms (" << mb / (t2 - t1) << " MB/s, " << st.batches << " batches, working set ~"
+         << 13.0 * sizeof(double) * cfg.batch * cfg.depth / 1e6 << " MB)  identical output: " << (same ? "yes" : "no")
+         << endl;
+    std::remove(in_path.c_str());
+    std::remove(out_a.c_str());
+    std::remove(out_b.c_str());
+}
+
+// Async Writer
+void bench_async_writer() {
+    cout << "\n=== Async writer: ofstream vs pwrite vs writer thread vs io_uring, compute interleaved ===" << endl;
+    const size_t chunk = size_t(1) << 16, chunks = 2048;    // 128 MB of prices
+    const string path = std::filesystem::temp_directory_path().string() + "/bs_async_writer.bin";
+    vector<double> S(chunk / sizeof(double), 100.0), K(S.size()), r(S.size(), 0.03), q(S.size(), 0.01),
+        sigma(S.size(), 0.2), T(S.size(), 1.0), price(S.size());
+    for (size_t i = 0; i < K.size(); ++i) K[i] = 60.0 + 80.0 * i / K.size();
+
+    // Each round prices one chunk and hands it to the sink; `blocked` is wall time spent in the
+    // sink, `cpu` the caller's own CPU time there (blocked - cpu: waiting or preempted).
+    auto thread_cpu = [] {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+    };
+    auto run = [&](const char* name, auto&& sink, auto&& finish) {
+        double blocked = 0.0, cpu = 0.0;
+        const double t0 = now_seconds();
+        for (size_t c = 0; c < chunks; ++c) {
+            quant::bs_price_call_batch(S.data(), K.data(), r.data(), q.data(), sigma.data(), T.data(), price.data(),
+                                       price.size());
+            const double w0 = now_seconds(), c0 = thread_cpu();
+            sink(price.data(), chunk);
+            blocked += now_seconds() - w0;
+            cpu += thread_cpu() - c0;
+        }
+        const double w0 = now_seconds(), c0 = thread_cpu();
+        finish();
+        blocked += now_seconds() - w0;
+        cpu += thread_cpu() - c0;
+        const double total = now_seconds() - t0;
+        cout << "  " << left << setw(22) << name << right << " total " << total * 1e3 << "ms  blocked in writes "
+             << blocked * 1e3 << "ms (" << 100.0 * blocked / total << "%), caller CPU " << cpu * 1e3 << "ms" << endl;
+        std::remove(path.c_str());
+    };
+
+    {
+        ofstream o(path, ios::binary);
+        run("ofstream", [&](const double* p, size_t n) { o.write(reinterpret_cast<const char*>(p), n); },
+            [&] { o.close(); });
+    }
+    // 0: pwrite on the caller, 1: writer thread (default), 2: io_uring
+    for (int mode : {0, 1, 2})
+        for (bool direct : {false, true}) {
+            quant::AsyncWriterConfig cfg;
+            cfg.writer_thread = mode == 1;
+            cfg.use_io_uring = mode == 2;
+            cfg.direct = direct;
+            quant::AsyncFileWriter w(path, cfg);
+            const string name = string(w.uses_io_uring() ? "io_uring" : w.uses_writer_thread() ? "writer thread" : "pwrite")
+                              + (w.uses_direct_io() ? "+O_DIRECT" : "") + (mode == 2 && !w.uses_io_uring() ? " (uring n/a)" : "");
+            run(name.c_str(), [&](const double* p, size_t n) { w.write(p, n); }, [&] { w.close(); });
+            if (mode != 0) cout << "    (" << w.stalls() << " waits for a free buffer)" << endl;
+        }
+}
+
+// Columnar Codec
+void bench_columnar() {
+    cout << "\n=== Columnar codec: big h-sweep as CSV vs raw doubles vs QCOL ===" << endl;
+    const size_t scenarios = 4000, grid = 25, rows = scenarios * grid;
+    const vector<string> names = {
+        "h_rel", "h", "Delta_analytic", "Delta_fd", "Delta_cs", "err_D_fd", "err_D_cs",
+        "Gamma_analytic", "Gamma_fd", "Gamma_cs_real", "Gamma_cs_45",
+        "err_G_fd", "err_G_cs_real", "err_G_cs_45"};
+    vector<vector<double>> cols(names.size(), vector<double>(rows));
+    vector<double> h_rel(grid);
+    for (size_t i = 0; i < grid; ++i) h_rel[i] = pow(10.0, -16.0 + i * 0.5);
+    for (size_t sc = 0; sc < scenarios; ++sc) {
+        const double S = 80.0 + 40.0 * (sc % 50) / 50.0, sigma = 0.05 + 0.01 * (sc % 40), T = 0.05 + 0.05 * (sc % 20);
+        vector<double> h(grid);
+        for (size_t i = 0; i < grid; ++i) h[i] = h_rel[i] * S;
+        const AnalyticGreeks a = compute_analytic_greeks(S, 100.0, 0.02, 0.0, sigma, T);
+        const HGridGreeks g = compute_greeks_h_grid(S, 100.0, 0.02, 0.0, sigma, T, h);
+        for (size_t i = 0; i < grid; ++i) {
+            const double row[] = {h_rel[i], h[i], a.delta, g.fd[i].delta, g.cs[i].delta,
+                                  abs(g.fd[i].delta - a.delta), abs(g.cs[i].delta - a.delta),
+                                  a.gamma, g.fd[i].gamma, g.cs[i].gamma_real, g.cs[i].gamma_45,
+                                  abs(g.fd[i].gamma - a.gamma), abs(g.cs[i].gamma_real - a.gamma),
+                                  abs(g.cs[i].gamma_45 - a.gamma)};
+            for (size_t c = 0; c < names.size(); ++c) cols[c][sc * grid + i] = row[c];
+        }
+    }
+    const string dir = std::filesystem::temp_directory_path().string();
+    const string csv_path = dir + "/bs_columnar.csv", qcol_path = dir + "/bs_columnar.qcol";
+
+    {
+        ofstream csv(csv_path);
+        csv << setprecision(16) << scientific;
+        for (size_t c = 0; c < names.size(); ++c) csv << (c ? "," : "") << names[c];
+        csv << '\n';
+        for (size_t i = 0; i < rows; ++i)
+            for (size_t c = 0; c < names.size(); ++c) csv << cols[c][i] << (c + 1 < names.size() ? ',' : '\n');
+    }
+    vector<const double*> ptrs;
+    for (const auto& c : cols) ptrs.push_back(c.data());
+    // The five err_* columns are |estimate - analytic| of stored columns.
+    const vector<quant::ColumnarAbsDiff> derived = {{5, 3, 2}, {6, 4, 2}, {11, 8, 7}, {12, 9, 7}, {13, 10, 7}};
+    double t0 = now_seconds();
+    const uint64_t qbytes = quant::write_columnar(qcol_path, names, ptrs, rows, 4096, grid, derived);
+    const double t_write = now_seconds() - t0;
+    const uint64_t csv_bytes = std::filesystem::file_size(csv_path), raw_bytes = rows * names.size() * sizeof(double);
+    cout << "  " << rows << " rows x " << names.size() << " columns" << endl;
+    cout << "  CSV       " << csv_bytes << " bytes" << endl;
+    cout << "  raw f64   " << raw_bytes << " bytes (" << double(csv_bytes) / raw_bytes << "x smaller than CSV)" << endl;
+    cout << "  QCOL      " << qbytes << " bytes (" << double(csv_bytes) / qbytes << "x vs CSV, "
+         << double(raw_bytes) / qbytes << "x vs raw), encoded in " << t_write * 1e3 << "ms" << endl;
+
+    // What each chunk encoding would cost alone (stored columns, better of the two lags).
+    uint64_t gorilla_only = 0, shuffle_only = 0;
+    for (size_t c = 0; c < names.size(); ++c) {
+        if (c == 5 || c == 6 || c >= 11) continue;
+        for (size_t first = 0; first < rows; first += 4096) {
+            const size_t m = min<size_t>(4096, rows - first);
+            size_t g = SIZE_MAX, sh = SIZE_MAX;
+            for (const size_t lag : {size_t(1), grid}) {
+                vector<uint8_t> a, b;
+                quant::gorilla_encode(cols[c].data() + first, m, a, lag);
+                quant::shuffle_encode(cols[c].data() + first, m, b, lag);
+                g = min(g, a.size());
+                sh = min(sh, b.size());
+            }
+            gorilla_only += g;
+            shuffle_only += sh;
+        }
+    }
+    cout << "  stored column payloads: Gorilla only " << gorilla_only << " bytes, byte-shuffle only "
+         << shuffle_only << " bytes, per-chunk best as written" << endl;
+
+    // Full read back: parse the CSV vs decode every chunk.
+    t0 = now_seconds();
+    vector<vector<double>> parsed(names.size(), vector<double>(rows));
+    {
+        ifstream in(csv_path);
+        string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const char* p = text.c_str();
+        p = strchr(p, '\n') + 1;
+        for (size_t i = 0; i < rows; ++i)
+            for (size_t c = 0; c < names.size(); ++c) {
+                char* end;
+                parsed[c][i] = strtod(p, &end);
+                p = end + 1;
+            }
+    }
+    const double t_csv = now_seconds() - t0;
+    t0 = now_seconds();
+    quant::ColumnarReader reader(qcol_path);
+    vector<vector<double>> decoded;
+    for (size_t c = 0; c < reader.names().size(); ++c) decoded.push_back(reader.read_column(c));
+    const double t_qcol = now_seconds() - t0;
+    bool exact = true;
+    for (size_t c = 0; c < names.size(); ++c)
+        exact = exact && memcmp(decoded[c].data(), cols[c].data(), rows * sizeof(double)) == 0
+                && memcmp(parsed[c].data(), cols[c].data(), rows * sizeof(double)) == 0;
+    cout << "  full read: CSV parse " << t_csv * 1e3 << "ms, QCOL decode " << t_qcol * 1e3 << "ms ("
+         << t_csv / t_qcol << "x), bit-exact " << (exact ? "yes" : "NO") << endl;
+
+    // Random access: one scenario's Gamma_fd slice, touching a single chunk.
+    vector<double> slice(grid);
+    const size_t gamma_fd = reader.column("Gamma_fd");
+    t0 = now_seconds();
+    for (size_t k = 0; k < 1000; ++k) reader.read_rows(gamma_fd, ((k * 7919) % scenarios) * grid, grid, slice.data());
+    cout << "  random scenario slice (25 rows of one column): " << (now_seconds() - t0) * 1e6 / 1000 << "us" << endl;
+    const size_t err_g_fd = reader.column("err_G_fd");
+    t0 = now_seconds();
+    for (size_t k = 0; k < 1000; ++k) reader.read_rows(err_g_fd, ((k * 7919) % scenarios) * grid, grid, slice.data());
+    cout << "  random scenario slice of a derived err column: " << (now_seconds() - t0) * 1e6 / 1000 << "us" << endl;
+    std::remove(csv_path.c_str());
+    std::remove(qcol_path.c_str());
+}
+
+// Checkpointed Sweep
+void bench_sweep_checkpoint() {
+    cout << "\n=== Sweep engine: checkpoint cost and interrupted + resumed vs uninterrupted ===" << endl;
+    const size_t n = 200000, width = 4;
+    const string dir = std::filesystem::temp_directory_path().string();
+    const string out = dir + "/bs_sweep.qsw", ck = dir + "/bs_sweep.ckpt";
+    std::atomic<bool> cancel{false};
+    std::atomic<size_t> evaluated{0};
+    auto eval = [&](size_t, uint64_t seed, double* rec) {
+        std::mt19937_64 rng(seed);
+        const double K = 60.0 + 80.0 * (rng() >> 11) * 0x1p-53, sigma = 0.05 + 0.6 * (rng() >> 11) * 0x1p-53;
+        const AnalyticGreeks a = compute_analytic_greeks(100.0, K, 0.03, 0.01, sigma, 1.0);
+        rec[0] = K;
+        rec[1] = sigma;
+        rec[2] = a.delta;
+        rec[3] = a.gamma;
+        if (evaluated.fetch_add(1, std::memory_order_relaxed) + 1 == n / 2) cancel.store(true);
+    };
+    auto file_bytes = [](const string& p) {
+        ifstream in(p, ios::binary);
+        return string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+
+    quant::SweepConfig cfg;
+    double t0 = now_seconds();
+    const quant::SweepResult plain = quant::run_sweep(out, n, width, eval, cfg);
+    const double t_plain = now_seconds() - t0;
+    const string reference = file_bytes(out);
+
+    cfg.checkpoint = ck;
+    cfg.checkpoint_seconds = 0.0;   // after every block
+    std::remove(ck.c_str());
+    t0 = now_seconds();
+    const quant::SweepResult every = quant::run_sweep(out, n, width, eval, cfg);
+    const double t_every = now_seconds() - t0;
+    cout << "  " << n << " scenarios, block " << cfg.block << ": no checkpoints " << t_plain * 1e3
+         << "ms, checkpoint every block " << t_every * 1e3 << "ms (" << every.checkpoints << " checkpoints, "
+         << std::filesystem::file_size(ck) << " bytes each at the end)" << endl;
+
+    std::remove(ck.c_str());
+    evaluated = 0;
+    cancel = false;
+    cfg.cancel = &cancel;
+    cfg.checkpoint_seconds = 1e9;   // only on cancel and at the end
+    const quant::SweepResult first = quant::run_sweep(out, n, width, eval, cfg);
+    cancel = false;
+    const quant::SweepResult second = quant::run_sweep(out, n, width, eval, cfg);
+    bool same = file_bytes(out) == reference && second.complete;
+    for (size_t c = 0; c < width; ++c)
+        same = same && memcmp(&second.stats[c], &plain.stats[c], sizeof(quant::WelfordStats)) == 0
+               && memcmp(&every.stats[c], &plain.stats[c], sizeof(quant::WelfordStats)) == 0;
+    cout << "  cancelled at " << first.done << ", resumed from " << second.resumed_from
+         << ": output and statistics bit-identical to the uninterrupted run: " << (same ? "yes" : "NO") << endl;
+    std::remove(out.c_str());
+    std::remove(ck.c_str());
+}
+
+// Sharded Sweep
+void bench_sweep_shards() {
+    cout << "\n=== Sharded sweep: 4 shards + merge vs one run ===" << endl;
+    const size_t n = 500000, width = 4, shards = 4;
+    const string dir = std::filesystem::temp_directory_path().string() + "/";
+    auto eval = [](size_t i, uint64_t seed, double* rec) {
+        const double K = 60.0 + 80.0 * (seed >> 11) * 0x1p-53, sigma = 0.05 + 0.001 * (i % 600);
+        const AnalyticGreeks a = compute_analytic_greeks(100.0, K, 0.03, 0.01, sigma, 1.0);
+        rec[0] = K;
+        rec[1] = sigma;
+        rec[2] = a.delta;
+        rec[3] = a.gamma;
+    };
+    auto file_bytes = [](const string& p) {
+        ifstream in(p, ios::binary);
+        return string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+
+    quant::SweepConfig cfg;
+    cfg.checkpoint = dir + "bs_single.ckpt";
+    std::remove(cfg.checkpoint.c_str());
+    double t0 = now_seconds();
+    quant::run_sweep(dir + "bs_single.qsw", n, width, eval, cfg);
+    const double t_single = now_seconds() - t0;
+
+    // Each shard would be its own process (or node); here they run one after another.
+    vector<quant::SweepShard> parts;
+    double t_slowest = 0.0;
+    cfg.shards = shards;
+    for (unsigned i = 0; i < shards; ++i) {
+        parts.push_back({dir + "bs_shard" + to_string(i) + ".qsw", dir + "bs_shard" + to_string(i) + ".ckpt"});
+        cfg.shard = i;
+        cfg.checkpoint = parts.back().checkpoint;
+        std::remove(cfg.checkpoint.c_str());
+        t0 = now_seconds();
+        quant::run_sweep(parts.back().output, n, width, eval, cfg);
+        t_slowest = max(t_slowest, now_seconds() - t0);
+    }
+    t0 = now_seconds();
+    quant::merge_sweep_shards(parts, dir + "bs_merged.qsw", dir + "bs_merged.ckpt");
+    const double t_merge = now_seconds() - t0;
+    const bool same = file_bytes(dir + "bs_merged.qsw") == file_bytes(dir + "bs_single.qsw")
+                   && file_bytes(dir + "bs_merged.ckpt") == file_bytes(dir + "bs_single.ckpt");
+    const double mb = (n * width * sizeof(double)) / 1e6;
+    cout << "  one run " << t_single * 1e3 << "ms; slowest of " << shards << " shards " << t_slowest * 1e3
+         << "ms + merge " << t_merge * 1e3 << "ms (" << mb / t_merge << " MB/s)" << endl;
+    cout << "  merged output and checkpoint byte-identical to the single run: " << (same ? "yes" : "NO") << endl;
+    for (const string stem : {"bs_single", "bs_merged", "bs_shard0", "bs_shard1", "bs_shard2", "bs_shard3"}) {
+        std::remove((dir + stem + ".qsw").c_str());
+        std::remove((dir + stem + ".ckpt").c_str());
+    }
+}
+
+// Result Cache
+void bench_result_cache() {
+    cout << "\n=== Result cache: cold, warm, partly changed and extended h-grid sweeps ===" << endl;
+    const size_t scenarios = 4000, points = 25, extended = 31;
+    const string path = std::filesystem::temp_directory_path().string() + "/bs_result_cache.bin";
+    std::remove(path.c_str());
+    vector<double> h_rel;   // 10^-16 .. 10^-4, as in the validation sweep, then up to 10^-1
+    for (size_t i = 0; i < extended; ++i) h_rel.push_back(pow(10.0, -16.0 + i * 0.5));
+    // Scenario k; with `shift`, every tenth scenario's vol moves (a partly changed rerun).
+    auto scenario = [](size_t k, bool shift) {
+        const double sigma = 0.1 + 0.0002 * k + (shift && k % 10 == 0 ? 0.01 : 0.0);
+        return array<double, 6>{100.0, 70.0 + 0.015 * k, 0.02, 0.0, sigma, 0.5};
+    };
+
+    // One pass over all scenarios on the first `steps` grid points; `bad` counts points
+    // differing from a direct, uncached run and `computed` the steps actually priced.
+    auto pass = [&](quant::ResultCache* cache, bool shift, size_t steps, size_t& bad, size_t& computed) {
+        const double t0 = now_seconds();
+        vector<HGridGreeks> results;
+        for (size_t k = 0; k < scenarios; ++k) {
+            const auto [S, K, r, q, sigma, T] = scenario(k, shift);
+            vector<double> h(steps);
+            for (size_t i = 0; i < steps; ++i) h[i] = h_rel[i] * S;
+            results.push_back(quant::cached_greeks_h_grid(cache, S, K, r, q, sigma, T, h, &computed));
+        }
+        const double t = now_seconds() - t0;
+        for (size_t k = 0; k < scenarios; ++k) {
+            const auto [S, K, r, q, sigma, T] = scenario(k, shift);
+            vector<double> h(steps);
+            for (size_t i = 0; i < steps; ++i) h[i] = h_rel[i] * S;
+            const HGridGreeks ref = compute_greeks_h_grid(S, K, r, q, sigma, T, h);
+            for (size_t i = 0; i < steps; ++i)
+                bad += memcmp(&ref.fd[i], &results[k].fd[i], sizeof(FDGreeks)) != 0
+                     || memcmp(&ref.cs[i], &results[k].cs[i], sizeof(CSGreeks)) != 0;
+        }
+        return t;
+    };
+
+    // Sized for the sweep plus the changed tenth, so the table never grows.
+    const size_t expected = scenarios + scenarios / 10;
+    size_t bad = 0, direct_steps = 0, cold_steps = 0, warm_steps = 0, changed_steps = 0, extended_steps = 0;
+    const double t_direct = pass(nullptr, false, points, bad, direct_steps);
+    double t_cold, t_warm, t_changed, t_extended;
+    {
+        quant::ResultCache cache(path, quant::h_grid_cache_width(32), expected);
+        t_cold = pass(&cache, false, points, bad, cold_steps);
+        cache.flush();
+    }
+    {
+        quant::ResultCache cache(path, quant::h_grid_cache_width(32), expected);   // reopened: the table persisted
+        t_warm = pass(&cache, false, points, bad, warm_steps);
+        t_changed = pass(&cache, true, points, bad, changed_steps);
+        t_extended = pass(&cache, false, extended, bad, extended_steps);
+        cout << "  " << scenarios << " scenarios x " << points << " steps; " << cache.size() << " records, "
+             << std::filesystem::file_size(path) / 1e6 << " MB" << endl;
+    }
+    cout << "  direct " << t_direct * 1e3 << "ms | cold (compute + insert) " << t_cold * 1e3 << "ms ("
+         << t_cold / t_direct << "x direct) | warm (all hits) " << t_warm * 1e3 << "ms (" << t_direct / t_warm
+         << "x faster)" << endl;
+    cout << "  10% changed " << t_changed * 1e3 << "ms, " << changed_steps << " of " << scenarios * points
+         << " steps computed | grid extended to " << extended << " steps " << t_extended * 1e3 << "ms, "
+         << extended_steps << " of " << scenarios * extended << " steps computed" << endl;
+    cout << "  cached results bit-identical to direct runs: " << (bad == 0 ? "yes" : "NO")
+         << (warm_steps == 0 ? "" : " (warm pass priced steps)") << endl;
+    std::remove(path.c_str());
+}
+
+// Main Program
+
+int main(int argc, char** argv) {
+    // Optional arguments name the sections to run, e.g. `bs_benchmark icn_derivative`
+    const vector<pair<string, void (*)()>> sections = {
+        {"rqmc", bench_rqmc},
+        {"variance_reduction", bench_variance_reduction},
+        {"sequential_stopping", bench_sequential_stopping},
+        {"term_strip", bench_term_strip},
+        {"merton", bench_merton},
+        {"bump_kernel", bench_bump_kernel},
+        {"fused_complex_step", bench_fused_complex_step},
+        {"h_grid", bench_h_grid},
+        {"adaptive_steps", bench_adaptive_steps},
+        {"cs_first_order", bench_cs_first_order},
+        {"adjoint", bench_adjoint},
+        {"icn_derivative", bench_icn_derivative},
+        {"small_vol_regime", bench_small_vol_regime},
+        {"normalised_black", bench_normalised_black},
+        {"ladder", bench_ladder},
+        {"option_book", bench_option_book},
+        {"huge_pages", bench_huge_pages},
+        {"task_scheduler", bench_task_scheduler},
+        {"task_graph", bench_task_graph},
+        {"stream_pipeline", bench_stream_pipeline},
+        {"async_writer", bench_async_writer},
+        {"columnar", bench_columnar},
+        {"sweep_checkpoint", bench_sweep_checkpoint},
+        {"sweep_shards", bench_sweep_shards},
+        {"result_cache", bench_result_cache},
+    };
+    cout << setprecision(10);
+    for (const auto& [name, run] : sections)
+        if (argc < 2 || find(argv + 1, argv + argc, name) != argv + argc) run();
+    return 0;
+}
@@ -0,0 +1,250 @@
+#pragma once
+/**
+ * @file bs_complex_step.h
+ * @brief Type-dispatched Black–Scholes call price for complex-step differentiation.
+ *
+ * Exposes:
+ *  - Phi_t(z):                     Φ for double, first-order complex extension for complex<double>.
+ *  - bs_price_call_t(S,K,r,q,σ,T): call price templated on the scalar type.
+ *  - bs_price_call_cs_lanes(...):  fused kernel for many complex spots (SoA re/im lanes)
+ *                                  with real parameters (the complex-step Greek stencil).
+ *  - bs_price_call_cs_spots(...):  the same on an array of std::complex spots.
+ *  - bs_price_call_cs_axes(...):   complex step along S, σ, r, q and T for many options at
+ *                                  once (one real chain per option, five first-order
+ *                                  imaginary parts carried through it).
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+
+#include "bs_batch.h"
+#include "bs_call_price.h"
+
+// Type-dispatched Φ_t for complex-step differentiation
+
+// Overload for double - uses Phi_real from bs_call_price.h
+inline double Phi_t(double z) {
+    return Phi_real(z);
+}
+
+// Overload for complex - first-order Taylor expansion
+// Φ(z_r + i*z_i) ≈ Φ(z_r) + i*z_i*φ(z_r)
+
+inline std::complex<double> Phi_t(const std::complex<double>& z) {
+    double z_real = z.real();
+    double z_imag = z.imag();
+    double phi_real = Phi_real(z_real);
+    double phi_derivative = phi(z_real);  // Φ'(z) = φ(z)
+    return std::complex<double>(phi_real, z_imag * phi_derivative);
+}
+
+// Templated Black-Scholes call price for complex-step
+
+template<class T>
+T bs_price_call_t(T S, T K, T r, T q, T sigma, T Tmat) {
+    using std::exp; using std::log; using std::sqrt;
+
+    const T DF = exp(-r * Tmat);
+    const T F = S * exp((r - q) * Tmat);
+    const T sigmaT = sigma * sqrt(Tmat);
+    
+    // For complex type, assume valid positive inputs
+    T ln_F_over_K = log(F / K);
+    
+    const T d1 = (ln_F_over_K + T(0.5) * sigma * sigma * Tmat) / sigmaT;
+    const T d2 = d1 - sigmaT;
+
+    return DF * (F * Phi_t(d1) - K * Phi_t(d2));
+}
+
+namespace detail {
+
+// Taylor expansion of Φ and φ about d0: φ(d0 + δ) = φ(d0)·Σ b[k]·δ^k with
+// b[k] = (−1)^k He_k(d0)/k!, and Φ(d0 + δ) = Φ(d0) + φ(d0)·δ·Σ a[k]·δ^k, a[k] = b[k]/(k+1).
+struct NormalExpansion {
+    static constexpr int order = 6;
+    static constexpr double inv_fact[order + 1] = {1.0, 1.0, 1.0 / 2, 1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720};
+    double N0 = 0.0, n0 = 0.0, b[order] = {}, a[order] = {};
+
+    NormalExpansion() = default;
+    explicit NormalExpansion(double d0) : N0(Phi_real(d0)), n0(phi(d0)) {
+        double he_prev = 0.0, he = 1.0;   // He_{-1} (unused), He_0
+        for (int k = 0; k < order; ++k) {
+            const double sgn = k % 2 ? -he : he;
+            b[k] = sgn * inv_fact[k];
+            a[k] = sgn * inv_fact[k + 1];
+            const double next = d0 * he - k * he_prev;   // He_{k+1} = d·He_k − k·He_{k−1}
+            he_prev = he;
+            he = next;
+        }
+    }
+
+    // Φ and φ at d0 + δ, given a = |δ|·(|d0| + 1) ≤ 1e-3; the truncation error is below
+    // a^6/6! relative (a^3/3! of δ for Φ and a^4/4! for φ when a < 1e-5, the short path
+    // a complex-step stencil takes).
+    void at(double delta, double a_scale, double& N, double& n) const {
+        if (a_scale < 1e-5) {
+            N = N0 + n0 * delta * (a[0] + delta * (a[1] + delta * a[2]));
+            n = n0 * (b[0] + delta * (b[1] + delta * (b[2] + delta * b[3])));
+            return;
+        }
+        double p = a[order - 1], q = b[order - 1];
+        for (int k = order - 2; k >= 0; --k) {
+            p = p * delta + a[k];
+            q = q * delta + b[k];
+        }
+        N = N0 + n0 * delta * p;
+        n = n0 * q;
+    }
+};
+
+} // namespace detail
+
+// Fused complex-step kernel for the Greek stencil, SoA lanes: spots S_re[i] + i·S_im[i]
+// are complex, K, r, q, σ, T real. Parameter-only terms (DF, carry, σ√T, σ²T/2) are
+// formed once and the spot terms use split real/imaginary arithmetic. With Phi_t's
+// first-order extension,
+//   Im C = DF·[Im F·Φ(Re d1) − Im d1·φ(Re d1)·(Im F)²/(Re F + |F|)]
+// (Kφ(Re d2) = |F|φ(Re d1)), so the imaginary part needs Φ and φ at Re d1 only. Lanes
+// [0, n_full) also get the real part (Φ at Re d2, or the small-σ√T series); lanes
+// [n_full, n) get C_re = 0.
+//
+// A stencil's spots sit within a few h of one real spot, so Φ and φ are evaluated once,
+// at d1 (and d2) of S_re[0], and every lane whose Re d1 lies close to that takes them
+// from a Taylor expansion in δ = Re d1 − d1(S_re[0]); ln(Re S / S_re[0]) is a series too.
+// A stencil then needs one erfc/exp pair (two with real parts) instead of one per lane.
+// That pays off across the h-grid's 3n lanes; a single three-lane stencil stays at about
+// two real pricings, bound by the exp → log → Φ → lane dependency chain, not by Φ count.
+// Lanes farther out (|δ|·(|d| + 1) > 1e-3) are evaluated directly.
+inline void bs_price_call_cs_lanes(const double* S_re, const double* S_im, double K, double r, double q,
+                                   double sigma, double T, double* C_re, double* C_im, std::size_t n,
+                                   std::size_t n_full) {
+    if (n == 0) return;
+    const double DF     = std::exp(-r * T);
+    const double carry  = std::exp((r - q) * T);
+    const double sigmaT = sigma * std::sqrt(T);
+    const double half   = 0.5 * sigma * sigma * T;
+
+    const double S0 = S_re[0], inv_S0 = 1.0 / S0, inv_sigmaT = 1.0 / sigmaT;
+    // ln(S0/K) + (r − q)T rather than ln(S0·carry/K): the log need not wait for the exp
+    const double d0 = (quant::detail::bs_log_moneyness(S0, K) + (r - q) * T + half) / sigmaT;
+    const detail::NormalExpansion at_d1(d0);
+    detail::NormalExpansion at_d2;
+    if (n_full > 0) at_d2 = detail::NormalExpansion(d0 - sigmaT);
+    constexpr double near = 1e-3;   // (1e-3)^6 / 6! ≈ 1.4e-21
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const double Fr = S_re[i] * carry;
+        const double Fi = S_im[i] * carry;
+        const double t  = Fi / Fr;
+        const double t2 = t * t;
+        // log(F/K) = ln(Re F/K) + ½ln(1 + t²) + i·atan(t)   (Re F > 0), and
+        // (Im F)²/(Re F + |F|) = Re F·t²/(1 + √(1 + t²)). Complex-step stencils have
+        // |t| ≲ 1e-4, where short series are exact to double precision.
+        double arg, half_log, fi2;
+        if (std::abs(t) < 1e-3) {
+            arg      = t * (1.0 - t2 * (1.0 / 3.0 - t2 * (1.0 / 5.0 - t2 * (1.0 / 7.0))));
+            half_log = 0.5 * t2 * (1.0 - t2 * (0.5 - t2 * (1.0 / 3.0)));
+            fi2      = Fr * (0.5 * t2 * (1.0 - t2 * (0.25 - t2 * 0.125)));
+        } else {
+            arg      = std::atan(t);
+            half_log = 0.5 * std::log1p(t2);
+            fi2      = Fi * Fi / (Fr + Fr * std::sqrt(1.0 + t2));
+        }
+        // ln(Re S / S0), a series within 1e-3 of S0 (error below x^7/7)
+        const double x = (S_re[i] - S0) * inv_S0;
+        const double ln_ratio = std::abs(x) < 1e-3
+            ? x * (1.0 - x * (0.5 - x * (1.0 / 3.0 - x * (0.25 - x * (0.2 - x * (1.0 / 6.0))))))
+            : std::log1p(x);
+        const double delta = (ln_ratio + half_log) * inv_sigmaT;
+        const double d1r = d0 + delta;
+        const double d1i = arg / sigmaT;
+        double N1, n1;
+        const double a1 = std::abs(delta) * (std::abs(d0) + 1.0);
+        if (a1 <= near) {
+            at_d1.at(delta, a1, N1, n1);
+        } else {
+            N1 = Phi_real(d1r);
+            n1 = phi(d1r);
+        }
+
+        C_im[i] = DF * (Fi * N1 - d1i * n1 * fi2);
+        // Re part on the same footing as bs_price_call (small-σ√T series where it applies)
+        if (i >= n_full) {
+            C_re[i] = 0.0;
+        } else if (bs_small_vol_regime(sigmaT, d1r)) {
+            C_re[i] = DF * (bs_small_vol_terms(sigmaT, d1r).call_undiscounted(Fr, K) - Fi * d1i * n1);
+        } else {
+            double N2, n2;
+            const double a2 = std::abs(delta) * (std::abs(d0 - sigmaT) + 1.0);
+            if (a2 <= near) at_d2.at(delta, a2, N2, n2);
+            else N2 = Phi_real(d1r - sigmaT);
+            C_re[i] = DF * (Fr * N1 - Fi * d1i * n1 - K * N2);
+        }
+    }
+}
+
+// Same kernel on interleaved complex spots: out[i] = bs_price_call_t(S[i], K, r, q, σ, T),
+// with Re out[i] = 0 for i >= n_full.
+inline void bs_price_call_cs_spots(const std::complex<double>* S, double K, double r, double q,
+                                   double sigma, double T, std::complex<double>* out, std::size_t n,
+                                   std::size_t n_full) {
+    constexpr std::size_t chunk = 64;
+    double S_re[chunk], S_im[chunk], C_re[chunk], C_im[chunk];
+    for (std::size_t base = 0; base < n; base += chunk) {
+        const std::size_t m = std::min(chunk, n - base);
+        for (std::size_t i = 0; i < m; ++i) {
+            S_re[i] = S[base + i].real();
+            S_im[i] = S[base + i].imag();
+        }
+        const std::size_t full = n_full > base ? std::min(n_full - base, m) : 0;
+        bs_price_call_cs_lanes(S_re, S_im, K, r, q, sigma, T, C_re, C_im, m, full);
+        for (std::size_t i = 0; i < m; ++i) out[base + i] = std::complex<double>(C_re[i], C_im[i]);
+    }
+}
+
+// Number of imaginary lanes per option in bs_price_call_cs_axes, in this order.
+inline constexpr std::size_t cs_axes = 5;
+enum CSAxisLane { cs_lane_S = 0, cs_lane_sigma, cs_lane_r, cs_lane_q, cs_lane_T };
+
+// First-order complex step along every input: lane a of option i is bs_price_call_t with
+// Im(input a) = h[a] and every other input real. The real chain (DF, F, σ√T, ln(F/K), d1,
+// d2, Φ and φ) is formed once per option; each axis then carries only the first-order
+// imaginary part through it, the same truncation Phi_t applies to Φ, so a lane costs a
+// handful of multiplies and Im C / h differs from the analytic Greek by rounding alone.
+// C_re[i] is the real price on the same footing as bs_price_call (small-σ√T series where
+// it applies); C_im is axis-major: C_im[a·n + i]. Inputs are assumed valid (σ, T > 0).
+inline void bs_price_call_cs_axes(const double* S, const double* K, const double* r, const double* q,
+                                  const double* sigma, const double* T, const double h[cs_axes],
+                                  double* C_re, double* C_im, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const double Si = S[i], Ki = K[i], ri = r[i], qi = q[i], gi = sigma[i], Ti = T[i];
+        const double DF    = std::exp(-ri * Ti);
+        const double carry = std::exp((ri - qi) * Ti);
+        const double F     = Si * carry;
+        const double sqT   = std::sqrt(Ti);
+        const double v     = gi * sqT;
+        const double d1    = (quant::detail::bs_log_moneyness(F, Ki) + 0.5 * gi * gi * Ti) / v;
+        const double d2    = d1 - v;
+        const double N1 = Phi_real(d1), N2 = Phi_real(d2);
+        const double Fn1 = F * phi(d1), Kn2 = Ki * phi(d2);
+        const double X = F * N1 - Ki * N2;
+
+        // Imaginary part of C for input tangents (dS, dσ, dr, dq, dT), first order throughout.
+        auto lane = [&](double dS, double dg, double dr, double dq, double dT) {
+            const double dF  = carry * dS + F * ((dr - dq) * Ti + (ri - qi) * dT);
+            const double dv  = dg * sqT + 0.5 * gi * dT / sqT;
+            const double dd1 = (dF / F + gi * Ti * dg + 0.5 * gi * gi * dT - d1 * dv) / v;
+            const double dX  = dF * N1 + Fn1 * dd1 - Kn2 * (dd1 - dv);
+            return DF * (dX - (dr * Ti + ri * dT) * X);
+        };
+        C_im[cs_lane_S * n + i]     = lane(h[cs_lane_S], 0.0, 0.0, 0.0, 0.0);
+        C_im[cs_lane_sigma * n + i] = lane(0.0, h[cs_lane_sigma], 0.0, 0.0, 0.0);
+        C_im[cs_lane_r * n + i]     = lane(0.0, 0.0, h[cs_lane_r], 0.0, 0.0);
+        C_im[cs_lane_q * n + i]     = lane(0.0, 0.0, 0.0, h[cs_lane_q], 0.0);
+        C_im[cs_lane_T * n + i]     = lane(0.0, 0.0, 0.0, 0.0, h[cs_lane_T]);
+        C_re[i] = bs_small_vol_regime(v, d1) ? DF * bs_small_vol_terms(v, d1).call_undiscounted(F, Ki) : DF * X;
+    }
+}
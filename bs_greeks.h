@@ -0,0 +1,256 @@
+#pragma once
+/**
+ * @file bs_greeks.h
+ * @brief Black-Scholes call Greeks: analytic, forward FD, complex-step.
+ *
+ * Exposes:
+ *  - compute_analytic_greeks(S,K,r,q,σ,T):  closed form (ground truth).
+ *  - compute_fd_greeks(S,K,r,q,σ,T,h):      forward differences C(S), C(S+h), C(S+2h).
+ *  - compute_cs_greeks(S,K,r,q,σ,T,h):      complex-step delta, real-part and 45° gamma.
+ *  - compute_greeks_h_grid(...):            FD and CS Greeks for a whole grid of steps
+ *                                           (h_grid_kernel_version tags cached results).
+ *  - compute_analytic_first_order(...):     delta, vega, rho, dividend rho, theta in one pass.
+ *  - compute_cs_first_order(_batch)(...):   the same five by complex step (bs_price_call_cs_axes).
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include "bs_call_price.h"
+#include "bs_complex_step.h"
+#include "bs_bump.h"
+
+// TASK 1: Analytic Greeks
+
+
+struct AnalyticGreeks {
+    double delta;
+    double gamma;
+};
+
+inline AnalyticGreeks compute_analytic_greeks(double S, double K, double r, double q, 
+                                              double sigma, double T) {
+    AnalyticGreeks greeks;
+    
+    const double F = S * std::exp((r - q) * T);
+    const double sigmaT = sigma * std::sqrt(std::max(T, 0.0));
+    
+    if (sigmaT < 1e-15) {
+        // At expiry or zero vol, Greeks are discontinuous
+        greeks.delta = (F > K) ? std::exp(-q * T) : 0.0;
+        greeks.gamma = 0.0;
+        return greeks;
+    }
+
+    double ln_F_over_K;
+    if (K > 0.0) {
+        const double x = (F - K) / K;
+        ln_F_over_K = (std::abs(x) <= 1e-12) ? std::log1p(x) : std::log(F / K);
+    } else {
+        ln_F_over_K = std::log(F / K);
+    }
+    
+    const double d1 = (ln_F_over_K + 0.5 * sigma * sigma * T) / sigmaT;
+    
+    // Delta = e^(-qT) * Φ(d1)   (erfc-free series when σ√T is small near the money)
+    const double N1 = bs_small_vol_regime(sigmaT, d1) ? bs_small_vol_terms(sigmaT, d1).Phi_d1() : Phi_real(d1);
+    greeks.delta = std::exp(-q * T) * N1;
+    
+    // Gamma = e^(-qT) * φ(d1) / (S * σ * √T)
+    // Use log-space computation to avoid underflow: log(φ(d1)) = -d1²/2 - log(√(2π))
+    const double log_phi_d1 = -0.5 * d1 * d1 - 0.5 * std::log(2.0 * M_PI);
+    const double phi_d1 = std::exp(log_phi_d1);
+    
+    greeks.gamma = std::exp(-q * T) * phi_d1 / (S * sigmaT);
+    
+    return greeks;
+}
+
+// TASK 2: Forward Finite Difference Greeks
+
+struct FDGreeks {
+    double delta;
+    double gamma;
+};
+
+inline FDGreeks compute_fd_greeks(double S, double K, double r, double q, 
+                                  double sigma, double T, double h) {
+    FDGreeks greeks;
+    
+    // C(S), C(S+h), C(S+2h) in one bump kernel call (invariants shared across the stencil)
+    const double bumps[3] = {0.0, h, 2.0*h};
+    double C[3];
+    quant::bs_price_call_bumped({S, K, r, q, sigma, T}, quant::BumpAxis::Spot, bumps, C, 3);
+    const double C_S = C[0], C_Sph = C[1], C_Sp2h = C[2];
+    
+    // Delta_fwd = (C(S+h) - C(S)) / h
+    greeks.delta = (C_Sph - C_S) / h;
+    
+    // Gamma_fwd = (C(S+2h) - 2*C(S+h) + C(S)) / h²
+    greeks.gamma = (C_Sp2h - 2.0*C_Sph + C_S) / (h * h);
+    
+    return greeks;
+}
+
+// TASK 3 & 4: Complex-Step Differentiation Greeks
+
+
+struct CSGreeks {
+    double delta;
+    double gamma_real;  // Using real-part method
+    double gamma_45;    // Using 45-degree method
+};
+
+inline CSGreeks compute_cs_greeks(double S, double K, double r, double q, 
+                                  double sigma, double T, double h) {
+    CSGreeks greeks;
+    
+    // ω = e^(iπ/4) = (1+i)/√2 for the 45-degree gamma
+    const double sqrt2 = std::sqrt(2.0);
+    std::complex<double> omega(1.0/sqrt2, 1.0/sqrt2);
+    
+    // All three complex spots in one fused call; K, r, q, σ, T stay real.
+    // Only C(S+ih) needs its real part (real-part gamma); the 45° pair needs Im only.
+    const std::complex<double> spots[3] = {
+        std::complex<double>(S, h),   // S + ih
+        S + h * omega,           // S + hω
+        S - h * omega            // S - hω
+    };
+    std::complex<double> C[3];
+    bs_price_call_cs_spots(spots, K, r, q, sigma, T, C, 3, 1);
+    const std::complex<double> C_complex = C[0], C_plus = C[1], C_minus = C[2];
+    
+    // DELTA: Δ_cs = Im[C(S + ih)] / h
+    greeks.delta = C_complex.imag() / h;
+    
+    // GAMMA (real-part method): Γ = -2 * [Re(C(S+ih)) - C(S)] / h²
+    double C_S = bs_price_call(S, K, r, q, sigma, T);
+    greeks.gamma_real = -2.0 * (C_complex.real() - C_S) / (h * h);
+    
+    // GAMMA (45-degree method): Γ = Im[C(S+hω) + C(S-hω)] / h²
+    greeks.gamma_45 = (C_plus + C_minus).imag() / (h * h);
+    
+    return greeks;
+}
+
+// Step-size grid: every h in one pass
+
+
+struct HGridGreeks {
+    std::vector<FDGreeks> fd;
+    std::vector<CSGreeks> cs;
+};
+
+// Bump when compute_greeks_h_grid's numbers change: cached results (result_cache.h) are keyed on it.
+inline constexpr unsigned h_grid_kernel_version = 3;
+
+// Same numbers as compute_fd_greeks / compute_cs_greeks at each h[i], but h is the
+// vector dimension: the real lanes hold C(S), C(S+h_i), C(S+2h_i) (one bump-kernel
+// call), the complex SoA lanes hold S+ih_i | S+h_iω | S-h_iω (one fused CS call).
+inline HGridGreeks compute_greeks_h_grid(double S, double K, double r, double q,
+                                         double sigma, double T, const std::vector<double>& h) {
+    const std::size_t n = h.size();
+    
+    // Real lanes: [0 | h_0..h_{n-1} | 2h_0..2h_{n-1}]
+    std::vector<double> bumps(2 * n + 1), C(2 * n + 1);
+    bumps[0] = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        bumps[1 + i] = h[i];
+        bumps[1 + n + i] = 2.0 * h[i];
+    }
+    quant::bs_price_call_bumped({S, K, r, q, sigma, T}, quant::BumpAxis::Spot, bumps.data(), C.data(), 2 * n + 1);
+    const double C_S = C[0];
+    
+    // Complex lanes: real part needed only for S+ih (real-part gamma)
+    const double sqrt2 = std::sqrt(2.0);
+    const std::complex<double> omega(1.0/sqrt2, 1.0/sqrt2);
+    std::vector<double> S_re(3 * n), S_im(3 * n), C_re(3 * n), C_im(3 * n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::complex<double> up = S + h[i] * omega, dn = S - h[i] * omega;
+        S_re[i] = S;              S_im[i] = h[i];
+        S_re[n + i] = up.real();  S_im[n + i] = up.imag();
+        S_re[2*n + i] = dn.real(); S_im[2*n + i] = dn.imag();
+    }
+    bs_price_call_cs_lanes(S_re.data(), S_im.data(), K, r, q, sigma, T, C_re.data(), C_im.data(), 3 * n, n);
+    
+    HGridGreeks out{std::vector<FDGreeks>(n), std::vector<CSGreeks>(n)};
+    for (std::size_t i = 0; i < n; ++i) {
+        const double hi = h[i];
+        const double C_Sph = C[1 + i], C_Sp2h = C[1 + n + i];
+        out.fd[i].delta = (C_Sph - C_S) / hi;
+        out.fd[i].gamma = (C_Sp2h - 2.0*C_Sph + C_S) / (hi * hi);
+        
+        out.cs[i].delta = C_im[i] / hi;
+        out.cs[i].gamma_real = -2.0 * (C_re[i] - C_S) / (hi * hi);
+        out.cs[i].gamma_45 = (C_im[n + i] + C_im[2*n + i]) / (hi * hi);
+    }
+    return out;
+}
+
+// First-order Greeks: every input at once
+
+
+struct FirstOrderGreeks {
+    double delta;         // ∂C/∂S
+    double vega;          // ∂C/∂σ
+    double rho;           // ∂C/∂r
+    double dividend_rho;  // ∂C/∂q
+    double theta;         // -∂C/∂T (calendar time decay)
+};
+
+// Fused closed form: one d1/d2, one Φ/φ pair and the two discount factors serve all five.
+inline FirstOrderGreeks compute_analytic_first_order(double S, double K, double r, double q,
+                                                     double sigma, double T) {
+    const double sqrtT = std::sqrt(T);
+    const double sigmaT = sigma * sqrtT;
+    const double DFq = std::exp(-q * T);
+    const double DFr = std::exp(-r * T);
+    const double F = S * std::exp((r - q) * T);
+    
+    const double d1 = (std::log(F / K) + 0.5 * sigma * sigma * T) / sigmaT;
+    const double d2 = d1 - sigmaT;
+    const double SN1 = S * DFq * Phi_real(d1);
+    const double KN2 = K * DFr * Phi_real(d2);
+    const double Sn1 = S * DFq * phi(d1);
+    
+    FirstOrderGreeks g;
+    g.delta = DFq * Phi_real(d1);
+    g.vega = Sn1 * sqrtT;
+    g.rho = T * KN2;
+    g.dividend_rho = -T * SN1;
+    g.theta = -0.5 * Sn1 * sigma / sqrtT - r * KN2 + q * SN1;
+    return g;
+}
+
+// All five complex-step Greeks for n options in one kernel call, imaginary step h on
+// every axis (no subtractive cancellation, so h only has to keep h² below roundoff).
+inline void compute_cs_first_order_batch(const double* S, const double* K, const double* r, const double* q,
+                                         const double* sigma, const double* T, FirstOrderGreeks* out,
+                                         std::size_t n, double h = 1e-20) {
+    constexpr std::size_t chunk = 64;
+    double C_re[chunk], C_im[cs_axes * chunk];
+    for (std::size_t base = 0; base < n; base += chunk) {
+        const std::size_t m = std::min(chunk, n - base);
+        const double steps[cs_axes] = {h, h, h, h, h};
+        bs_price_call_cs_axes(S + base, K + base, r + base, q + base, sigma + base, T + base,
+                              steps, C_re, C_im, m);
+        for (std::size_t i = 0; i < m; ++i) {
+            FirstOrderGreeks& g = out[base + i];
+            g.delta        = C_im[cs_lane_S * m + i] / h;
+            g.vega         = C_im[cs_lane_sigma * m + i] / h;
+            g.rho          = C_im[cs_lane_r * m + i] / h;
+            g.dividend_rho = C_im[cs_lane_q * m + i] / h;
+            g.theta        = -C_im[cs_lane_T * m + i] / h;
+        }
+    }
+}
+
+inline FirstOrderGreeks compute_cs_first_order(double S, double K, double r, double q,
+                                               double sigma, double T, double h = 1e-20) {
+    FirstOrderGreeks g;
+    compute_cs_first_order_batch(&S, &K, &r, &q, &sigma, &T, &g, 1, h);
+    return g;
+}
@@ -4,6 +4,14 @@
  * 
  * Uses provided header files:
  * - bs_call_price.h: Black-Scholes pricing with Phi_real, phi, and bs_price_call
+ * - bs_greeks.h: analytic, finite-difference and complex-step Greeks
+ * - step_search.h: adaptive (coarse + Brent) optimal step search
+ * - task_scheduler.h: shared work-stealing pool running the per-scenario sweeps
+ * - stream_pipeline.h: coroutine stages (row formatting → CSV writer) inside each sweep
+ * - columnar_codec.h: optional compressed column copy of each sweep (--columnar)
+ * - sweep_engine.h: checkpointed random-scenario grid sweep
+ *   (--grid-sweep N [--resume] [--shard i/N] [--out STEM]; merge shards with sweep_merge)
+ * - result_cache.h: persistent per-scenario cache of the FD/CS grid (--cache PATH)
  * - InverseCumulativeNormal.h: (Available but not needed for this assignment)
  */
 
@@ -15,175 +23,111 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <sstream>
+#include <utility>
+#include <atomic>
+#include <random>
+#include <csignal>
+#include <memory>
+#include <cstdio>
 
 // Include the provided headers
 #include "bs_call_price.h"
+#include "bs_greeks.h"
+#include "step_search.h"
+#include "task_scheduler.h"
+#include "stream_pipeline.h"
+#include "columnar_codec.h"
+#include "sweep_engine.h"
+#include "result_cache.h"
 // #include "InverseCumulativeNormal.h"  // Not needed for this assignment
 
 using namespace std;
 
-// Type-dispatched Φ_t for complex-step differentiation
-
-// Overload for double - uses Phi_real from bs_call_price.h
-inline double Phi_t(double z) {
-    return Phi_real(z);
-}
-
-// Overload for complex - first-order Taylor expansion
-// Φ(z_r + i*z_i) ≈ Φ(z_r) + i*z_i*φ(z_r)
-
-inline complex<double> Phi_t(const complex<double>& z) {
-    double z_real = z.real();
-    double z_imag = z.imag();
-    double phi_real = Phi_real(z_real);
-    double phi_derivative = phi(z_real);  // Φ'(z) = φ(z)
-    return complex<double>(phi_real, z_imag * phi_derivative);
-}
-
-// Templated Black-Scholes call price for complex-step
-    
-
-template<class T>
-T bs_price_call_t(T S, T K, T r, T q, T sigma, T Tmat) {
-    const T DF = exp(-r * Tmat);
-    const T F = S * exp((r - q) * Tmat);
-    const T sigmaT = sigma * sqrt(Tmat);
-    
-    // For complex type, assume valid positive inputs
-    T ln_F_over_K = log(F / K);
-    
-    const T d1 = (ln_F_over_K + T(0.5) * sigma * sigma * Tmat) / sigmaT;
-    const T d2 = d1 - sigmaT;
-
-    return DF * (F * Phi_t(d1) - K * Phi_t(d2));
-}
-
-// TASK 1: Analytic Greeks
+// Validation Sweep
 
 
-struct AnalyticGreeks {
-    double delta;
-    double gamma;
+struct Scenario {
+    string name;
+    double S, K, r, q, sigma, T;
 };
 
-AnalyticGreeks compute_analytic_greeks(double S, double K, double r, double q, 
-                                       double sigma, double T) {
-    AnalyticGreeks greeks;
+// CSV rows of one sweep (header first), pushed to the writer stage in h order.
+quant::PipelineTask sweep_rows(const vector<double>& h_rel_values, const vector<double>& h_values,
+                               const HGridGreeks& grid, const AnalyticGreeks& analytic,
+                               quant::Channel<string>& out) {
+    ostringstream row;
+    row << setprecision(16) << scientific;
     
-    const double F = S * exp((r - q) * T);
-    const double sigmaT = sigma * sqrt(max(T, 0.0));
+    // Write header (exact format required by assignment)
+    row << "h_rel,h,"
+        << "Delta_analytic,Delta_fd,Delta_cs,err_D_fd,err_D_cs,"
+        << "Gamma_analytic,Gamma_fd,Gamma_cs_real,Gamma_cs_45,"
+        << "err_G_fd,err_G_cs_real,err_G_cs_45\n";
+    co_await out.push(row.str());
     
-    if (sigmaT < 1e-15) {
-        // At expiry or zero vol, Greeks are discontinuous
-        greeks.delta = (F > K) ? exp(-q * T) : 0.0;
-        greeks.gamma = 0.0;
-        return greeks;
-    }
-
-    double ln_F_over_K;
-    if (K > 0.0) {
-        const double x = (F - K) / K;
-        ln_F_over_K = (abs(x) <= 1e-12) ? log1p(x) : log(F / K);
-    } else {
-        ln_F_over_K = log(F / K);
+    // Sweep over step sizes
+    for (size_t i = 0; i < h_rel_values.size(); ++i) {
+        double h_rel = h_rel_values[i];
+        double h = h_values[i];
+        const FDGreeks& fd = grid.fd[i];
+        const CSGreeks& cs = grid.cs[i];
+        
+        // Compute errors
+        double err_D_fd = abs(fd.delta - analytic.delta);
+        double err_D_cs = abs(cs.delta - analytic.delta);
+        double err_G_fd = abs(fd.gamma - analytic.gamma);
+        double err_G_cs_real = abs(cs.gamma_real - analytic.gamma);
+        double err_G_cs_45 = abs(cs.gamma_45 - analytic.gamma);
+        
+        row.str("");
+        row << h_rel << "," << h << ","
+            << analytic.delta << "," << fd.delta << "," << cs.delta << ","
+            << err_D_fd << "," << err_D_cs << ","
+            << analytic.gamma << "," << fd.gamma << "," 
+            << cs.gamma_real << "," << cs.gamma_45 << ","
+            << err_G_fd << "," << err_G_cs_real << "," << err_G_cs_45 << "\n";
+        if (!co_await out.push(row.str())) break;
     }
-    
-    const double d1 = (ln_F_over_K + 0.5 * sigma * sigma * T) / sigmaT;
-    
-    // Delta = e^(-qT) * Φ(d1)
-    greeks.delta = exp(-q * T) * Phi_real(d1);
-    
-    // Gamma = e^(-qT) * φ(d1) / (S * σ * √T)
-    // Use log-space computation to avoid underflow: log(φ(d1)) = -d1²/2 - log(√(2π))
-    const double log_phi_d1 = -0.5 * d1 * d1 - 0.5 * log(2.0 * M_PI);
-    const double phi_d1 = exp(log_phi_d1);
-    
-    greeks.gamma = exp(-q * T) * phi_d1 / (S * sigmaT);
-    
-    return greeks;
+    out.close();
 }
 
-// TASK 2: Forward Finite Difference Greeks
-
-struct FDGreeks {
-    double delta;
-    double gamma;
-};
-
-FDGreeks compute_fd_greeks(double S, double K, double r, double q, 
-                           double sigma, double T, double h) {
-    FDGreeks greeks;
-    
-    // Use bs_price_call from bs_call_price.h
-    double C_S = bs_price_call(S, K, r, q, sigma, T);
-    double C_Sph = bs_price_call(S + h, K, r, q, sigma, T);
-    double C_Sp2h = bs_price_call(S + 2.0*h, K, r, q, sigma, T);
-    
-    // Delta_fwd = (C(S+h) - C(S)) / h
-    greeks.delta = (C_Sph - C_S) / h;
-    
-    // Gamma_fwd = (C(S+2h) - 2*C(S+h) + C(S)) / h²
-    greeks.gamma = (C_Sp2h - 2.0*C_Sph + C_S) / (h * h);
-    
-    return greeks;
-}
-
-// TASK 3 & 4: Complex-Step Differentiation Greeks
-
-
-struct CSGreeks {
-    double delta;
-    double gamma_real;  // Using real-part method
-    double gamma_45;    // Using 45-degree method
-};
-
-CSGreeks compute_cs_greeks(double S, double K, double r, double q, 
-                           double sigma, double T, double h) {
-    CSGreeks greeks;
-    
-    // Convert all parameters to complex type (with zero imaginary part)
-    complex<double> K_c(K, 0.0);
-    complex<double> r_c(r, 0.0);
-    complex<double> q_c(q, 0.0);
-    complex<double> sigma_c(sigma, 0.0);
-    complex<double> T_c(T, 0.0);
-    
-    // DELTA: Δ_cs = Im[C(S + ih)] / h
-    complex<double> S_plus_ih(S, h);
-    complex<double> C_complex = bs_price_call_t(S_plus_ih, K_c, r_c, q_c, sigma_c, T_c);
-    greeks.delta = C_complex.imag() / h;
-    
-    // GAMMA (real-part method): Γ = -2 * [Re(C(S+ih)) - C(S)] / h²
-    double C_S = bs_price_call(S, K, r, q, sigma, T);
-    greeks.gamma_real = -2.0 * (C_complex.real() - C_S) / (h * h);
-    
-    // GAMMA (45-degree method): Γ = Im[C(S+hω) + C(S-hω)] / h²
-    // where ω = e^(iπ/4) = (1+i)/√2
-    const double sqrt2 = sqrt(2.0);
-    complex<double> omega(1.0/sqrt2, 1.0/sqrt2);
-    
-    complex<double> S_plus_homega = S + h * omega;
-    complex<double> S_minus_homega = S - h * omega;
-    
-    complex<double> C_plus = bs_price_call_t(S_plus_homega, K_c, r_c, q_c, sigma_c, T_c);
-    complex<double> C_minus = bs_price_call_t(S_minus_homega, K_c, r_c, q_c, sigma_c, T_c);
-    
-    greeks.gamma_45 = (C_plus + C_minus).imag() / (h * h);
-    
-    return greeks;
+// The sweep columns (CSV header order) for the compressed columnar copy. The err_*
+// columns are |estimate - analytic| and are rebuilt on read rather than stored; a file
+// holds one grid, so there is no period for the codec to match.
+uint64_t write_sweep_columnar(const string& path, const vector<double>& h_rel_values,
+                              const vector<double>& h_values, const HGridGreeks& grid,
+                              const AnalyticGreeks& analytic) {
+    const vector<string> names = {
+        "h_rel", "h", "Delta_analytic", "Delta_fd", "Delta_cs", "err_D_fd", "err_D_cs",
+        "Gamma_analytic", "Gamma_fd", "Gamma_cs_real", "Gamma_cs_45",
+        "err_G_fd", "err_G_cs_real", "err_G_cs_45"};
+    const size_t n = h_values.size();
+    vector<vector<double>> cols(names.size(), vector<double>(n));
+    for (size_t i = 0; i < n; ++i) {
+        const FDGreeks& fd = grid.fd[i];
+        const CSGreeks& cs = grid.cs[i];
+        const double row[] = {
+            h_rel_values[i], h_values[i], analytic.delta, fd.delta, cs.delta,
+            abs(fd.delta - analytic.delta), abs(cs.delta - analytic.delta),
+            analytic.gamma, fd.gamma, cs.gamma_real, cs.gamma_45,
+            abs(fd.gamma - analytic.gamma), abs(cs.gamma_real - analytic.gamma),
+            abs(cs.gamma_45 - analytic.gamma)};
+        for (size_t c = 0; c < names.size(); ++c) cols[c][i] = row[c];
+    }
+    vector<const double*> ptrs;
+    for (const auto& c : cols) ptrs.push_back(c.data());
+    const vector<quant::ColumnarAbsDiff> derived = {{5, 3, 2}, {6, 4, 2}, {11, 8, 7}, {12, 9, 7}, {13, 10, 7}};
+    return quant::write_columnar(path, names, ptrs, n, 4096, 0, derived);
 }
 
-// Validation Sweep
-
-
-struct Scenario {
-    string name;
-    double S, K, r, q, sigma, T;
-};
-
-void run_validation_sweep(const Scenario& scenario, const string& output_file) {
-    cout << "\n=== Running validation for " << scenario.name << " ===" << endl;
-    cout << "S=" << scenario.S << ", K=" << scenario.K 
+// Console report goes to `log` so scenarios can run on separate threads.
+// With `columnar`, a compressed .qcol copy of the sweep is written next to the CSV;
+// with a `cache`, grid points computed by earlier runs are reused.
+void run_validation_sweep(const Scenario& scenario, const string& output_file, ostream& log = cout,
+                          bool columnar = false, quant::ResultCache* cache = nullptr) {
+    log << "\n=== Running validation for " << scenario.name << " ===" << endl;
+    log << "S=" << scenario.S << ", K=" << scenario.K 
          << ", r=" << scenario.r << ", q=" << scenario.q 
          << ", σ=" << scenario.sigma << ", T=" << scenario.T << endl;
     
@@ -192,8 +136,8 @@ void run_validation_sweep(const Scenario& scenario, const string& output_file) {
         scenario.S, scenario.K, scenario.r, scenario.q, scenario.sigma, scenario.T
     );
     
-    cout << "Analytic Delta = " << setprecision(15) << analytic.delta << endl;
-    cout << "Analytic Gamma = " << setprecision(15) << analytic.gamma << endl;
+    log << "Analytic Delta = " << setprecision(15) << analytic.delta << endl;
+    log << "Analytic Gamma = " << setprecision(15) << analytic.gamma << endl;
     
     // Create logarithmic grid: h_rel from 10^-16 to 10^-4
     // Using 24 intervals = 25 points
@@ -203,53 +147,207 @@ void run_validation_sweep(const Scenario& scenario, const string& output_file) {
         h_rel_values.push_back(pow(10.0, log_h_rel));
     }
     
-    // Open CSV file for output
+    // FD and CS Greeks for the whole grid in one kernel call (h is the lane dimension)
+    vector<double> h_values;
+    for (double h_rel : h_rel_values) h_values.push_back(h_rel * scenario.S);
+    const HGridGreeks grid = quant::cached_greeks_h_grid(
+        cache, scenario.S, scenario.K, scenario.r, scenario.q, scenario.sigma, scenario.T, h_values
+    );
+    
+    // Rows are formatted by one pipeline stage and written by another
+    quant::AsyncFileWriter csv(output_file);
+    quant::Pipeline pipeline;
+    quant::Channel<string> rows(pipeline, 8);
+    pipeline.spawn(sweep_rows(h_rel_values, h_values, grid, analytic, rows));
+    pipeline.spawn(quant::write_lines(rows, csv));
+    pipeline.run();
+    
+    csv.close();
+    log << "Results written to " << output_file << endl;
+    
+    if (columnar) {
+        const string qcol = output_file.substr(0, output_file.rfind('.')) + ".qcol";
+        const uint64_t bytes = write_sweep_columnar(qcol, h_rel_values, h_values, grid, analytic);
+        log << "Columnar copy written to " << qcol << " (" << bytes << " bytes vs "
+            << h_values.size() * 14 * sizeof(double) << " raw doubles, " << csv.bytes_written() << " CSV)" << endl;
+    }
+}
+
+// First-order Greeks: fused complex step vs analytic
+
+// All five first-order Greeks per scenario: fused CS kernel, the per-axis templated
+// complex pricing it replaces, and the fused analytic kernel as ground truth.
+void run_first_order_validation(const vector<Scenario>& scenarios, const string& output_file) {
     ofstream csv(output_file);
     csv << setprecision(16) << scientific;
+    csv << "scenario,greek,analytic,cs_fused,cs_template,err_fused,err_template\n";
     
-    // Write header (exact format required by assignment)
-    csv << "h_rel,h,"
-        << "Delta_analytic,Delta_fd,Delta_cs,err_D_fd,err_D_cs,"
-        << "Gamma_analytic,Gamma_fd,Gamma_cs_real,Gamma_cs_45,"
-        << "err_G_fd,err_G_cs_real,err_G_cs_45\n";
-    
-    // Sweep over step sizes
-    for (double h_rel : h_rel_values) {
-        double h = h_rel * scenario.S;
+    using C = complex<double>;
+    const double h = 1e-20;
+    for (const Scenario& sc : scenarios) {
+        const FirstOrderGreeks a = compute_analytic_first_order(sc.S, sc.K, sc.r, sc.q, sc.sigma, sc.T);
+        const FirstOrderGreeks f = compute_cs_first_order(sc.S, sc.K, sc.r, sc.q, sc.sigma, sc.T, h);
         
-        // Compute finite difference Greeks
-        FDGreeks fd = compute_fd_greeks(
-            scenario.S, scenario.K, scenario.r, scenario.q, scenario.sigma, scenario.T, h
-        );
-        
-        // Compute complex-step Greeks
-        CSGreeks cs = compute_cs_greeks(
-            scenario.S, scenario.K, scenario.r, scenario.q, scenario.sigma, scenario.T, h
-        );
-        
-        // Compute errors
-        double err_D_fd = abs(fd.delta - analytic.delta);
-        double err_D_cs = abs(cs.delta - analytic.delta);
-        double err_G_fd = abs(fd.gamma - analytic.gamma);
-        double err_G_cs_real = abs(cs.gamma_real - analytic.gamma);
-        double err_G_cs_45 = abs(cs.gamma_45 - analytic.gamma);
+        // One templated complex pricing per perturbed input
+        const double t_delta = bs_price_call_t<C>(C(sc.S, h), sc.K, sc.r, sc.q, sc.sigma, sc.T).imag() / h;
+        const double t_vega  = bs_price_call_t<C>(sc.S, sc.K, sc.r, sc.q, C(sc.sigma, h), sc.T).imag() / h;
+        const double t_rho   = bs_price_call_t<C>(sc.S, sc.K, C(sc.r, h), sc.q, sc.sigma, sc.T).imag() / h;
+        const double t_drho  = bs_price_call_t<C>(sc.S, sc.K, sc.r, C(sc.q, h), sc.sigma, sc.T).imag() / h;
+        const double t_theta = -bs_price_call_t<C>(sc.S, sc.K, sc.r, sc.q, sc.sigma, C(sc.T, h)).imag() / h;
         
-        // Write to CSV
-        csv << h_rel << "," << h << ","
-            << analytic.delta << "," << fd.delta << "," << cs.delta << ","
-            << err_D_fd << "," << err_D_cs << ","
-            << analytic.gamma << "," << fd.gamma << "," 
-            << cs.gamma_real << "," << cs.gamma_45 << ","
-            << err_G_fd << "," << err_G_cs_real << "," << err_G_cs_45 << "\n";
+        const struct { const char* name; double analytic, fused, templ; } rows[] = {
+            {"Delta", a.delta, f.delta, t_delta},
+            {"Vega", a.vega, f.vega, t_vega},
+            {"Rho", a.rho, f.rho, t_rho},
+            {"Dividend_rho", a.dividend_rho, f.dividend_rho, t_drho},
+            {"Theta", a.theta, f.theta, t_theta},
+        };
+        cout << "\n=== First-order Greeks for " << sc.name << " ===" << endl;
+        for (const auto& row : rows) {
+            const double err_fused = abs(row.fused - row.analytic);
+            const double err_templ = abs(row.templ - row.analytic);
+            cout << "  " << left << setw(13) << row.name << right << " analytic=" << row.analytic
+                 << "  |cs - analytic|=" << scientific << setprecision(3) << err_fused
+                 << " (template " << err_templ << ")" << defaultfloat << setprecision(15) << endl;
+            csv << sc.name << "," << row.name << "," << row.analytic << "," << row.fused << ","
+                << row.templ << "," << err_fused << "," << err_templ << "\n";
+        }
+    }
+    cout << "Results written to " << output_file << endl;
+}
+
+// Adaptive step-size search
+
+// Optimal h and minimal error per method, instead of the fixed 25-point grid.
+void run_adaptive_search(const vector<Scenario>& scenarios, const string& output_file) {
+    ofstream csv(output_file);
+    csv << setprecision(16) << scientific;
+    csv << "scenario,method,h_rel,h,min_error,evaluations\n";
+    
+    for (const Scenario& sc : scenarios) {
+        cout << "\n=== Adaptive step search for " << sc.name << " ===" << endl;
+        const vector<StepOptimum> best = find_optimal_steps(sc.S, sc.K, sc.r, sc.q, sc.sigma, sc.T);
+        int total = 0;
+        for (const StepOptimum& o : best) {
+            cout << "  " << left << setw(14) << greek_method_name(o.method) << right
+                 << " h_rel=" << scientific << setprecision(3) << o.h_rel
+                 << "  min error=" << o.error << defaultfloat << setprecision(15)
+                 << "  (" << o.evaluations << " evaluations)" << endl;
+            csv << sc.name << "," << greek_method_name(o.method) << "," << o.h_rel << ","
+                << o.h_rel * sc.S << "," << o.error << "," << o.evaluations << "\n";
+            total += o.evaluations;
+        }
+        cout << "  total: " << total << " step evaluations (7-point coarse pass + refinement, "
+             << "per method; the fixed grid is 25 x 5 = 125)" << endl;
     }
-    
-    csv.close();
     cout << "Results written to " << output_file << endl;
 }
 
+// Checkpointed grid sweep over random scenarios
+
+// Set by SIGINT / SIGTERM; the sweep checkpoints after the current block and exits.
+static std::atomic<bool> preempted{false};
+extern "C" void on_preempt(int) { preempted.store(true, std::memory_order_relaxed); }
+
+// Scenario i is drawn from its own seed; its record is the inputs followed by the
+// minimal error and the h_rel achieving it for each of the five FD / CS estimators.
+void grid_sweep_record(uint64_t seed, double* rec, quant::ResultCache* cache) {
+    mt19937_64 rng(seed);
+    uniform_real_distribution<double> u(0.0, 1.0);
+    const double S = 100.0, K = S * exp(u(rng) - 0.5), r = 0.08 * u(rng), q = 0.04 * u(rng);
+    const double sigma = 0.01 + 0.79 * u(rng), T = 1.0 / 365.0 + 5.0 * u(rng);
+    vector<double> h_rel(25), h(25);
+    for (int i = 0; i <= 24; ++i) {
+        h_rel[i] = pow(10.0, -16.0 + i * 0.5);
+        h[i] = h_rel[i] * S;
+    }
+    const AnalyticGreeks a = compute_analytic_greeks(S, K, r, q, sigma, T);
+    const HGridGreeks g = quant::cached_greeks_h_grid(cache, S, K, r, q, sigma, T, h);
+    const double inputs[] = {S, K, r, q, sigma, T};
+    copy(begin(inputs), end(inputs), rec);
+    for (int m = 0; m < 5; ++m) {
+        double best = INFINITY, best_h = h_rel[0];
+        for (size_t i = 0; i < h.size(); ++i) {
+            const double est[] = {g.fd[i].delta, g.cs[i].delta, g.fd[i].gamma, g.cs[i].gamma_real, g.cs[i].gamma_45};
+            const double err = abs(est[m] - (m < 2 ? a.delta : a.gamma));
+            if (err < best) { best = err; best_h = h_rel[i]; }
+        }
+        rec[6 + 2 * m] = best;
+        rec[7 + 2 * m] = best_h;
+    }
+}
+
+// Writes STEM.qsw and STEM.ckpt; a shard's default stem is bs_grid_sweep.shard-i-of-N.
+int run_grid_sweep(size_t scenarios, bool resume, unsigned shard, unsigned shards, string stem,
+                   quant::ResultCache* cache) {
+    const vector<string> columns = {
+        "S", "K", "r", "q", "sigma", "T",
+        "minerr_D_fd", "hrel_D_fd", "minerr_D_cs", "hrel_D_cs", "minerr_G_fd", "hrel_G_fd",
+        "minerr_G_cs_real", "hrel_G_cs_real", "minerr_G_cs_45", "hrel_G_cs_45"};
+    quant::SweepConfig cfg;
+    if (stem.empty())
+        stem = shards > 1 ? "bs_grid_sweep.shard-" + to_string(shard) + "-of-" + to_string(shards) : "bs_grid_sweep";
+    cfg.shard = shard;
+    cfg.shards = shards;
+    cfg.checkpoint = stem + ".ckpt";
+    cfg.checkpoint_seconds = 5.0;
+    cfg.fingerprint = quant::fnv1a64("bs_grid_sweep v1: random (K,r,q,sigma,T), 25-point h_rel grid");
+    cfg.cancel = &preempted;
+    if (!resume) remove(cfg.checkpoint.c_str());
+    signal(SIGINT, on_preempt);
+    signal(SIGTERM, on_preempt);
+    
+    const quant::SweepResult res = quant::run_sweep(
+        stem + ".qsw", scenarios, columns.size(),
+        [cache](size_t, uint64_t seed, double* rec) { grid_sweep_record(seed, rec, cache); }, cfg);
+    
+    cout << "Grid sweep: " << res.done << "/" << res.count << " scenarios";
+    if (shards > 1) cout << " of shard " << shard << "/" << shards << " [" << res.first << ", " << res.first + res.count << ")";
+    if (res.resumed_from) cout << " (resumed at " << res.resumed_from << ")";
+    cout << ", " << res.checkpoints << " checkpoints" << endl;
+    if (!res.complete) {
+        cout << "Interrupted; rerun with the same arguments and --resume to continue." << endl;
+        return 2;
+    }
+    for (size_t c = 6; c < columns.size(); ++c)
+        cout << "  " << setw(16) << left << columns[c] << right << " mean " << res.stats[c].mean
+             << "  sd " << sqrt(res.stats[c].variance()) << endl;
+    cout << "Records written to " << stem << ".qsw" << endl;
+    return 0;
+}
+
 // Main Program
 
-int main() {
+int main(int argc, char** argv) {
+    // --cache PATH, with any mode: each scenario's 25-point FD/CS grid is reused across runs.
+    // Records have room for 32 steps, so a finer grid over the same scenarios prices only
+    // the new steps; the table is opened at the mode's scenario count so it never grows.
+    string cache_path;
+    for (int a = 1; a + 1 < argc; ++a) {
+        if (string(argv[a]) != "--cache") continue;
+        cache_path = argv[a + 1];
+        for (int b = a; b + 2 <= argc; ++b) argv[b] = argv[b + 2];
+        argc -= 2;
+        break;
+    }
+    unique_ptr<quant::ResultCache> cache;
+    auto open_cache = [&](size_t expected_scenarios) {
+        if (cache_path.empty()) return;
+        try {
+            cache = make_unique<quant::ResultCache>(cache_path, quant::h_grid_cache_width(32), expected_scenarios);
+        } catch (const exception& e) {
+            cerr << e.what() << "; running without the cache" << endl;
+        }
+    };
+    auto report_cache = [&] {
+        if (!cache) return;
+        cache->flush();
+        cout << "Result cache: " << cache->hits() << " hits, " << cache->misses() << " computed, "
+             << cache->size() << " entries" << endl;
+    };
+    
+    const bool adaptive = (argc > 1 && string(argv[1]) == "--adaptive");
+    const bool columnar = (argc > 1 && string(argv[1]) == "--columnar");
     cout << setprecision(15);
     
     // Scenario 1: ATM reference (happy path)
@@ -274,14 +372,59 @@ int main() {
         1.0 / 365.0         // T = 1/365
     };
     
-    // Run validation sweeps for both scenarios
-    run_validation_sweep(scenario1, "bs_fd_vs_complex_scenario1.csv");
-    run_validation_sweep(scenario2, "bs_fd_vs_complex_scenario2.csv");
+    if (argc > 2 && string(argv[1]) == "--grid-sweep") {
+        bool resume = false;
+        unsigned shard = 0, shards = 1;
+        string stem;
+        for (int a = 3; a < argc; ++a) {
+            const string arg = argv[a];
+            if (arg == "--resume") {
+                resume = true;
+            } else if (arg == "--shard" && a + 1 < argc &&
+                       sscanf(argv[a + 1], "%u/%u", &shard, &shards) == 2 && shard < shards) {
+                ++a;
+            } else if (arg == "--out" && a + 1 < argc) {
+                stem = argv[++a];
+            } else {
+                cerr << "usage: " << argv[0] << " --grid-sweep N [--resume] [--shard i/N] [--out STEM] [--cache PATH]"
+                     << endl;
+                return 1;
+            }
+        }
+        open_cache(stoul(argv[2]) / shards + 1);
+        const int rc = run_grid_sweep(stoul(argv[2]), resume, shard, shards, stem, cache.get());
+        report_cache();
+        return rc;
+    }
+    
+    if (adaptive) {
+        run_adaptive_search({scenario1, scenario2}, "bs_optimal_steps.csv");
+        return 0;
+    }
+    
+    // Run validation sweeps for both scenarios, one scheduler task per scenario
+    open_cache(16);
+    const vector<pair<Scenario, string>> jobs = {
+        {scenario1, "bs_fd_vs_complex_scenario1.csv"},
+        {scenario2, "bs_fd_vs_complex_scenario2.csv"},
+    };
+    vector<ostringstream> logs(jobs.size());
+    quant::TaskGroup sweeps;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        logs[i] << setprecision(15);
+        sweeps.run([&, i] { run_validation_sweep(jobs[i].first, jobs[i].second, logs[i], columnar, cache.get()); });
+    }
+    sweeps.wait();
+    for (auto& l : logs) cout << l.str();
+    report_cache();
+    
+    run_first_order_validation({scenario1, scenario2}, "bs_first_order_greeks.csv");
     
     cout << "\n=== Validation Complete ===" << endl;
     cout << "\nGenerated files:" << endl;
     cout << "  - bs_fd_vs_complex_scenario1.csv" << endl;
     cout << "  - bs_fd_vs_complex_scenario2.csv" << endl;
+    cout << "  - bs_first_order_greeks.csv" << endl;
     cout << "\nNext steps:" << endl;
     cout << "  Run: python3 analyze_results.py" << endl;
     cout << "  to generate plots and statistical analysis." << endl;
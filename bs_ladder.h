@@ -0,0 +1,137 @@
+#pragma once
+/**
+ * @file bs_ladder.h
+ * @brief Spot × vol ladders of price and Greeks, per option and for a whole book.
+ *
+ * Exposes:
+ *  - LadderGrid:          relative spot shifts and absolute vol shifts.
+ *  - Ladder:              n_vol × n_spot matrices (row = vol, column = spot) of price,
+ *                         delta, gamma, vega, theta.
+ *  - bs_ladder(...):      one option's ladder, written into a reusable Ladder.
+ *  - bs_book_ladder(...): quantity-weighted sum of ladders over a book on one underlying.
+ *
+ * Per option, everything that depends on neither S nor σ (DF, e^{-qT}, carry, √T) is
+ * formed once, ln(F/K) once per spot column and σ√T, σ²T/2 once per vol row; the spot
+ * column is the vector dimension. Price, delta and gamma match bs_price_call and
+ * compute_analytic_greeks bit for bit (including the small-σ√T series); vega and theta
+ * are the closed forms of compute_analytic_first_order (equal to rounding, since Φ and φ
+ * are shared rather than recomputed). Vols and T must be positive.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "bs_batch.h"
+#include "bs_bump.h"
+#include "bs_call_price.h"
+
+namespace quant {
+
+struct LadderGrid {
+    std::vector<double> spot_shift;   // S·(1 + shift)
+    std::vector<double> vol_shift;    // σ + shift
+};
+
+struct Ladder {
+    std::size_t n_spot = 0, n_vol = 0;
+    std::vector<double> price, delta, gamma, vega, theta;   // [v·n_spot + s]
+
+    void resize(std::size_t spots, std::size_t vols) {
+        n_spot = spots;
+        n_vol = vols;
+        for (std::vector<double>* m : {&price, &delta, &gamma, &vega, &theta}) m->assign(spots * vols, 0.0);
+    }
+};
+
+namespace detail {
+
+// One option's ladder added into `out` with weight w (out must be sized to the grid).
+inline void bs_ladder_accumulate(const BSInput& opt, const LadderGrid& grid, double w, Ladder& out) {
+    const std::size_t nS = grid.spot_shift.size(), nV = grid.vol_shift.size();
+    const double K = opt.K, r = opt.r, q = opt.q, T = opt.T;
+
+    // Option invariants
+    const double DF    = std::exp(-r * T);
+    const double DFq   = std::exp(-q * T);
+    const double carry = std::exp((r - q) * T);
+    const double sqrtT = std::sqrt(T);
+    static const double log_sqrt_2pi = 0.5 * std::log(2.0 * M_PI);
+
+    // Spot columns
+    thread_local std::vector<double> S, F, x;
+    S.resize(nS); F.resize(nS); x.resize(nS);
+    for (std::size_t i = 0; i < nS; ++i) {
+        S[i] = opt.S * (1.0 + grid.spot_shift[i]);
+        F[i] = S[i] * carry;
+        x[i] = bs_log_moneyness(F[i], K);
+    }
+
+    double d1[bs_batch_chunk], N1[bs_batch_chunk], N2[bs_batch_chunk], n1[bs_batch_chunk], C[bs_batch_chunk];
+    bool small[bs_batch_chunk];
+    for (std::size_t v = 0; v < nV; ++v) {
+        // Vol row
+        const double sigma  = opt.sigma + grid.vol_shift[v];
+        const double sigmaT = sigma * sqrtT;
+        const double half   = 0.5 * sigma * sigma * T;
+        const std::size_t row = v * nS;
+
+        for (std::size_t base = 0; base < nS; base += bs_batch_chunk) {
+            const std::size_t m = std::min(bs_batch_chunk, nS - base);
+            const double *Sc = S.data() + base, *Fc = F.data() + base, *xc = x.data() + base;
+
+            std::size_t n_small = 0;
+            for (std::size_t i = 0; i < m; ++i) {
+                d1[i] = (xc[i] + half) / sigmaT;
+                small[i] = bs_small_vol_regime(sigmaT, d1[i]);
+                n_small += small[i];
+            }
+            for (std::size_t i = 0; i < m; ++i) n1[i] = std::exp(-0.5 * d1[i] * d1[i] - log_sqrt_2pi);
+            if (n_small < m) {
+                for (std::size_t i = 0; i < m; ++i) {
+                    N1[i] = Phi_real(d1[i]);
+                    N2[i] = Phi_real(d1[i] - sigmaT);
+                    C[i]  = DF * (Fc[i] * N1[i] - K * N2[i]);
+                }
+            }
+            if (n_small > 0) {
+                for (std::size_t i = 0; i < m; ++i) {
+                    if (!small[i]) continue;
+                    const SmallVolTerms t = bs_small_vol_terms(sigmaT, d1[i]);
+                    N1[i] = t.Phi_d1();
+                    N2[i] = t.Phi_d2();
+                    C[i]  = DF * t.call_undiscounted(Fc[i], K);
+                }
+            }
+            double *P = out.price.data() + row + base, *D = out.delta.data() + row + base;
+            double *G = out.gamma.data() + row + base, *V = out.vega.data() + row + base;
+            double *Th = out.theta.data() + row + base;
+            for (std::size_t i = 0; i < m; ++i) {
+                const double Sn1 = Sc[i] * DFq * n1[i];
+                P[i]  += w * C[i];
+                D[i]  += w * (DFq * N1[i]);
+                G[i]  += w * (DFq * n1[i] / (Sc[i] * sigmaT));
+                V[i]  += w * (Sn1 * sqrtT);
+                Th[i] += w * (-0.5 * Sn1 * sigma / sqrtT - r * K * DF * N2[i] + q * Sc[i] * DFq * N1[i]);
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+inline void bs_ladder(const BSInput& opt, const LadderGrid& grid, Ladder& out) {
+    out.resize(grid.spot_shift.size(), grid.vol_shift.size());
+    detail::bs_ladder_accumulate(opt, grid, 1.0, out);
+}
+
+// Σ_i qty[i]·ladder(book[i]): every position is shifted by the same relative spot and
+// absolute vol moves (one underlying), and results stream into one matrix.
+inline void bs_book_ladder(const BSInput* book, const double* qty, std::size_t n, const LadderGrid& grid,
+                           Ladder& out) {
+    out.resize(grid.spot_shift.size(), grid.vol_shift.size());
+    for (std::size_t i = 0; i < n; ++i) detail::bs_ladder_accumulate(book[i], grid, qty ? qty[i] : 1.0, out);
+}
+
+} // namespace quant
@@ -0,0 +1,511 @@
+#pragma once
+/**
+ * @file columnar_codec.h
+ * @brief Lossless Gorilla-style XOR compression of double columns in independently
+ *        decodable chunks, with a chunk index for random access.
+ *
+ * Exposes:
+ *  - gorilla_encode(values, n, out) / gorilla_decode(data, bytes, out, n): one chunk.
+ *  - shuffle_encode / shuffle_decode: the same XOR residuals split into byte planes with
+ *    zero bytes suppressed, the alternative encoding each chunk is also tried with.
+ *  - ColumnarAbsDiff:  declares a column that equals |minuend − subtrahend| of two stored
+ *                      columns (the err_* columns of a sweep); it is checked bit for bit,
+ *                      not stored, and rebuilt on read.
+ *  - write_columnar(path, names, columns, rows, chunk_rows, period, derived): every
+ *    (column, chunk) pair is encoded as a separate task (parallel_for), then written
+ *    behind a header and index. With a period (e.g. the h-grid length of a sweep, when
+ *    the file holds several grids), each chunk also tries XOR against the value one
+ *    period back; the smallest encoding is kept.
+ *  - ColumnarReader:   mmap of a written file; column names, row count, read_chunk (single
+ *                      chunk, random access), read_rows (a row range, touching only the
+ *                      chunks it spans), read_column (all chunks, decoded in parallel),
+ *                      column_bytes (stored size of a column).
+ *
+ * Chunk encoding (Pelkonen et al., "Gorilla", VLDB 2015, without timestamps): the first
+ * value raw; then per value x = bits ^ reference bits (previous value, or lag back) and
+ *   '0'                          x == 0 (repeat: constant columns cost 1 bit per row),
+ *   '10' + meaningful bits       x fits the previous leading/trailing-zero window,
+ *   '11' + 6b leading + 6b len + meaningful bits   otherwise.
+ * Round trips are bit-exact (NaN payloads and signed zeros included). The shuffled form
+ * keeps the residuals whole and writes byte plane b (most significant first) as a mode
+ * byte: 0 all zero, 1 raw, 2 nonzero bitmap + nonzero bytes.
+ *
+ * File layout (little-endian):
+ *   "QCOL0002" | u32 columns | u32 chunk_rows | u64 rows
+ *   per column: u16 name length, name bytes
+ *   u32 derived count; per derived column: u32 column, u32 minuend, u32 subtrahend
+ *   per column, per chunk: u64 offset (from file start), u64 bytes (0, 0 if derived)
+ *   chunk payloads: u32 lag (bit 31 set: shuffled), then the encoded residuals
+ * "QCOL0001" files (no derived section, Gorilla only) are still read.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "async_writer.h"
+#include "task_scheduler.h"
+
+namespace quant {
+
+namespace detail {
+
+class BitWriter {
+  public:
+    explicit BitWriter(std::vector<std::uint8_t>& out) : out_(out) {}
+
+    // Appends the low `n` bits of v (n ≤ 64), most significant first.
+    void put(std::uint64_t v, unsigned n) {
+        while (n > 0) {
+            const unsigned take = std::min(n, 64u - used_);
+            const std::uint64_t bits = (n == 64 && take == 64) ? v : (v >> (n - take)) & ((std::uint64_t(1) << take) - 1);
+            acc_ = take == 64 ? bits : (acc_ << take) | bits;
+            used_ += take;
+            n -= take;
+            if (used_ == 64) flush_word();
+        }
+    }
+
+    void finish() {
+        if (used_ == 0) return;
+        acc_ <<= 64 - used_;
+        const unsigned bytes = (used_ + 7) / 8;
+        for (unsigned b = 0; b < bytes; ++b) out_.push_back(static_cast<std::uint8_t>(acc_ >> (56 - 8 * b)));
+        acc_ = 0;
+        used_ = 0;
+    }
+
+  private:
+    void flush_word() {
+        for (unsigned b = 0; b < 8; ++b) out_.push_back(static_cast<std::uint8_t>(acc_ >> (56 - 8 * b)));
+        acc_ = 0;
+        used_ = 0;
+    }
+
+    std::vector<std::uint8_t>& out_;
+    std::uint64_t acc_ = 0;
+    unsigned used_ = 0;
+};
+
+class BitReader {
+  public:
+    BitReader(const std::uint8_t* data, std::size_t bytes) : data_(data), bytes_(bytes) {}
+
+    std::uint64_t get(unsigned n) {
+        std::uint64_t v = 0;
+        while (n > 0) {
+            if (avail_ == 0) refill();
+            const unsigned take = std::min(n, avail_);
+            const std::uint64_t bits = take == 64 ? acc_ : (acc_ >> (64 - take));
+            v = take == 64 ? bits : (v << take) | bits;
+            acc_ = take == 64 ? 0 : acc_ << take;
+            avail_ -= take;
+            n -= take;
+        }
+        return v;
+    }
+
+    unsigned bit() { return static_cast<unsigned>(get(1)); }
+
+  private:
+    void refill() {
+        acc_ = 0;
+        for (unsigned b = 0; b < 8; ++b) {
+            acc_ <<= 8;
+            if (pos_ < bytes_) acc_ |= data_[pos_];
+            ++pos_;
+        }
+        if (pos_ > bytes_ + 8) throw std::runtime_error("gorilla_decode: truncated chunk");
+        avail_ = 64;
+    }
+
+    const std::uint8_t* data_;
+    std::size_t bytes_, pos_ = 0;
+    std::uint64_t acc_ = 0;
+    unsigned avail_ = 0;
+};
+
+inline std::uint64_t double_bits(double x) {
+    std::uint64_t b;
+    std::memcpy(&b, &x, sizeof(b));
+    return b;
+}
+
+inline double bits_double(std::uint64_t b) {
+    double x;
+    std::memcpy(&x, &b, sizeof(x));
+    return x;
+}
+
+template <class T>
+void put_le(std::vector<std::uint8_t>& out, T v) {
+    for (std::size_t i = 0; i < sizeof(T); ++i) out.push_back(static_cast<std::uint8_t>(std::uint64_t(v) >> (8 * i)));
+}
+
+template <class T>
+T get_le(const std::uint8_t* p) {
+    std::uint64_t v = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) v |= std::uint64_t(p[i]) << (8 * i);
+    return static_cast<T>(v);
+}
+
+} // namespace detail
+
+// Appends the encoding of values[0, n) to `out`. Value i is XORed with value i - lag
+// (i - 1 for the first lag values): lag = 1 is classic Gorilla, lag = grid length
+// lines up rows that repeat from one scenario to the next.
+inline void gorilla_encode(const double* values, std::size_t n, std::vector<std::uint8_t>& out,
+                           std::size_t lag = 1) {
+    if (n == 0) return;
+    lag = std::max<std::size_t>(lag, 1);
+    detail::BitWriter w(out);
+    w.put(detail::double_bits(values[0]), 64);
+    unsigned lead = 65, trail = 0;   // previous window; 65 = none yet
+    for (std::size_t i = 1; i < n; ++i) {
+        const std::uint64_t cur = detail::double_bits(values[i]);
+        const std::uint64_t x = cur ^ detail::double_bits(values[i >= lag ? i - lag : i - 1]);
+        if (x == 0) { w.put(0, 1); continue; }
+        const unsigned l = std::min(static_cast<unsigned>(__builtin_clzll(x)), 63u);
+        const unsigned t = static_cast<unsigned>(__builtin_ctzll(x));
+        if (lead <= 64 && l >= lead && t >= trail) {
+            w.put(0b10, 2);
+            w.put(x >> trail, 64 - lead - trail);
+        } else {
+            const unsigned len = 64 - l - t;   // 1..64, stored as len - 1
+            w.put(0b11, 2);
+            w.put(l, 6);
+            w.put(len - 1, 6);
+            w.put(x >> t, len);
+            lead = l;
+            trail = t;
+        }
+    }
+    w.finish();
+}
+
+inline void gorilla_decode(const std::uint8_t* data, std::size_t bytes, double* out, std::size_t n,
+                           std::size_t lag = 1) {
+    if (n == 0) return;
+    lag = std::max<std::size_t>(lag, 1);
+    detail::BitReader r(data, bytes);
+    out[0] = detail::bits_double(r.get(64));
+    unsigned lead = 0, trail = 0;
+    for (std::size_t i = 1; i < n; ++i) {
+        std::uint64_t v = detail::double_bits(out[i >= lag ? i - lag : i - 1]);
+        if (r.bit()) {
+            if (r.bit()) {
+                lead = static_cast<unsigned>(r.get(6));
+                const unsigned len = static_cast<unsigned>(r.get(6)) + 1;
+                trail = 64 - lead - len;
+            }
+            v ^= r.get(64 - lead - trail) << trail;
+        }
+        out[i] = detail::bits_double(v);
+    }
+}
+
+// Same residuals as gorilla_encode (value i XOR value i - lag, the first value raw), as
+// eight byte planes; each plane is stored whole, as a bitmap of its nonzero bytes plus
+// those bytes, or not at all when it is zero.
+inline void shuffle_encode(const double* values, std::size_t n, std::vector<std::uint8_t>& out,
+                           std::size_t lag = 1) {
+    if (n == 0) return;
+    lag = std::max<std::size_t>(lag, 1);
+    std::vector<std::uint64_t> x(n);
+    x[0] = detail::double_bits(values[0]);
+    for (std::size_t i = 1; i < n; ++i)
+        x[i] = detail::double_bits(values[i]) ^ detail::double_bits(values[i >= lag ? i - lag : i - 1]);
+    const std::size_t bitmap = (n + 7) / 8;
+    for (unsigned b = 0; b < 8; ++b) {
+        const unsigned shift = 56 - 8 * b;
+        std::size_t nonzero = 0;
+        for (std::size_t i = 0; i < n; ++i) nonzero += ((x[i] >> shift) & 0xff) != 0;
+        if (nonzero == 0) { out.push_back(0); continue; }
+        if (bitmap + nonzero >= n) {
+            out.push_back(1);
+            for (std::size_t i = 0; i < n; ++i) out.push_back(static_cast<std::uint8_t>(x[i] >> shift));
+            continue;
+        }
+        out.push_back(2);
+        const std::size_t mask_at = out.size();
+        out.resize(mask_at + bitmap, 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::uint8_t v = static_cast<std::uint8_t>(x[i] >> shift);
+            if (v == 0) continue;
+            out[mask_at + i / 8] |= static_cast<std::uint8_t>(1u << (i % 8));
+            out.push_back(v);
+        }
+    }
+}
+
+inline void shuffle_decode(const std::uint8_t* data, std::size_t bytes, double* out, std::size_t n,
+                           std::size_t lag = 1) {
+    if (n == 0) return;
+    lag = std::max<std::size_t>(lag, 1);
+    std::vector<std::uint64_t> x(n, 0);
+    const std::size_t bitmap = (n + 7) / 8;
+    std::size_t pos = 0;
+    auto need = [&](std::size_t k) {
+        if (pos + k > bytes) throw std::runtime_error("shuffle_decode: truncated chunk");
+    };
+    for (unsigned b = 0; b < 8; ++b) {
+        const unsigned shift = 56 - 8 * b;
+        need(1);
+        const std::uint8_t mode = data[pos++];
+        if (mode == 1) {
+            need(n);
+            for (std::size_t i = 0; i < n; ++i) x[i] |= std::uint64_t(data[pos + i]) << shift;
+            pos += n;
+        } else if (mode == 2) {
+            need(bitmap);
+            const std::uint8_t* mask = data + pos;
+            pos += bitmap;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (!(mask[i / 8] >> (i % 8) & 1)) continue;
+                need(1);
+                x[i] |= std::uint64_t(data[pos++]) << shift;
+            }
+        } else if (mode != 0) {
+            throw std::runtime_error("shuffle_decode: corrupt chunk");
+        }
+    }
+    out[0] = detail::bits_double(x[0]);
+    for (std::size_t i = 1; i < n; ++i)
+        out[i] = detail::bits_double(x[i] ^ detail::double_bits(out[i >= lag ? i - lag : i - 1]));
+}
+
+inline constexpr char columnar_magic[8] = {'Q', 'C', 'O', 'L', '0', '0', '0', '2'};
+inline constexpr char columnar_magic_v1[8] = {'Q', 'C', 'O', 'L', '0', '0', '0', '1'};
+inline constexpr std::uint32_t columnar_shuffled = 0x80000000u;
+
+// Column `column` is |columns[minuend] - columns[subtrahend]| row for row.
+struct ColumnarAbsDiff {
+    std::size_t column, minuend, subtrahend;
+};
+
+// Writes `columns` (each `rows` long) to `path`; returns the file size in bytes.
+// With period > 1 each chunk is also encoded at lag = period; every lag is tried both
+// as Gorilla and byte-shuffled and the smallest encoding kept. A `derived` column that
+// reproduces bit for bit from its two stored columns is written as a header entry only;
+// one that does not (or would chain through another derived column) is stored like the rest.
+inline std::uint64_t write_columnar(const std::string& path, const std::vector<std::string>& names,
+                                    const std::vector<const double*>& columns, std::size_t rows,
+                                    std::size_t chunk_rows = 4096, std::size_t period = 0,
+                                    const std::vector<ColumnarAbsDiff>& derived = {},
+                                    TaskScheduler& s = TaskScheduler::global()) {
+    if (names.size() != columns.size()) throw std::invalid_argument("write_columnar: one name per column");
+    chunk_rows = std::max<std::size_t>(chunk_rows, 1);
+    const std::size_t n_cols = columns.size();
+    const std::size_t n_chunks = (rows + chunk_rows - 1) / chunk_rows;
+
+    std::vector<char> is_derived(n_cols, 0), is_operand(n_cols, 0);
+    std::vector<ColumnarAbsDiff> kept;
+    for (const ColumnarAbsDiff& d : derived) {
+        if (d.column >= n_cols || d.minuend >= n_cols || d.subtrahend >= n_cols)
+            throw std::out_of_range("write_columnar: derived column index");
+        if (is_derived[d.column] || is_operand[d.column] || is_derived[d.minuend] || is_derived[d.subtrahend]
+            || d.column == d.minuend || d.column == d.subtrahend) continue;
+        bool exact = true;
+        for (std::size_t i = 0; i < rows && exact; ++i)
+            exact = detail::double_bits(columns[d.column][i])
+                    == detail::double_bits(std::abs(columns[d.minuend][i] - columns[d.subtrahend][i]));
+        if (!exact) continue;
+        is_derived[d.column] = 1;
+        is_operand[d.minuend] = is_operand[d.subtrahend] = 1;
+        kept.push_back(d);
+    }
+
+    std::vector<std::vector<std::uint8_t>> payload(n_cols * n_chunks);
+    parallel_for(0, payload.size(), 1, [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t u = lo; u < hi; ++u) {
+            const std::size_t c = u / n_chunks, k = u % n_chunks;
+            if (is_derived[c]) continue;
+            const std::size_t first = k * chunk_rows, m = std::min(chunk_rows, rows - first);
+            std::vector<std::uint8_t>& best = payload[u];
+            std::vector<std::uint8_t> alt;
+            for (const std::size_t lag : {std::size_t(1), period}) {
+                if (lag != 1 && !(lag > 1 && lag < m)) continue;
+                for (const bool shuffled : {false, true}) {
+                    alt.clear();
+                    detail::put_le<std::uint32_t>(alt, static_cast<std::uint32_t>(lag) | (shuffled ? columnar_shuffled : 0));
+                    if (shuffled) shuffle_encode(columns[c] + first, m, alt, lag);
+                    else gorilla_encode(columns[c] + first, m, alt, lag);
+                    if (best.empty() || alt.size() < best.size()) best.swap(alt);
+                }
+            }
+        }
+    }, s);
+
+    std::vector<std::uint8_t> head(columnar_magic, columnar_magic + 8);
+    detail::put_le<std::uint32_t>(head, static_cast<std::uint32_t>(n_cols));
+    detail::put_le<std::uint32_t>(head, static_cast<std::uint32_t>(chunk_rows));
+    detail::put_le<std::uint64_t>(head, rows);
+    for (const std::string& name : names) {
+        detail::put_le<std::uint16_t>(head, static_cast<std::uint16_t>(name.size()));
+        head.insert(head.end(), name.begin(), name.end());
+    }
+    detail::put_le<std::uint32_t>(head, static_cast<std::uint32_t>(kept.size()));
+    for (const ColumnarAbsDiff& d : kept) {
+        detail::put_le<std::uint32_t>(head, static_cast<std::uint32_t>(d.column));
+        detail::put_le<std::uint32_t>(head, static_cast<std::uint32_t>(d.minuend));
+        detail::put_le<std::uint32_t>(head, static_cast<std::uint32_t>(d.subtrahend));
+    }
+    std::uint64_t offset = head.size() + 16 * payload.size();
+    for (const std::vector<std::uint8_t>& p : payload) {
+        detail::put_le<std::uint64_t>(head, p.empty() ? 0 : offset);
+        detail::put_le<std::uint64_t>(head, p.size());
+        offset += p.size();
+    }
+
+    AsyncFileWriter out(path);
+    out.write(head.data(), head.size());
+    for (const std::vector<std::uint8_t>& p : payload) out.write(p.data(), p.size());
+    out.close();
+    return offset;
+}
+
+class ColumnarReader {
+  public:
+    explicit ColumnarReader(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("ColumnarReader: cannot open " + path);
+        struct stat st{};
+        ::fstat(fd, &st);
+        size_ = static_cast<std::size_t>(st.st_size);
+        void* p = size_ ? ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("ColumnarReader: cannot map " + path);
+        data_ = static_cast<const std::uint8_t*>(p);
+
+        auto need = [&](std::size_t end) {
+            if (end > size_) throw std::runtime_error("ColumnarReader: truncated file " + path);
+        };
+        need(24);
+        const bool v1 = std::memcmp(data_, columnar_magic_v1, 8) == 0;
+        if (!v1 && std::memcmp(data_, columnar_magic, 8) != 0) throw std::runtime_error("ColumnarReader: not a QCOL file");
+        const std::size_t n_cols = detail::get_le<std::uint32_t>(data_ + 8);
+        chunk_rows_ = detail::get_le<std::uint32_t>(data_ + 12);
+        rows_ = detail::get_le<std::uint64_t>(data_ + 16);
+        n_chunks_ = chunk_rows_ ? (rows_ + chunk_rows_ - 1) / chunk_rows_ : 0;
+        std::size_t pos = 24;
+        for (std::size_t c = 0; c < n_cols; ++c) {
+            need(pos + 2);
+            const std::size_t len = detail::get_le<std::uint16_t>(data_ + pos);
+            need(pos + 2 + len);
+            names_.emplace_back(reinterpret_cast<const char*>(data_ + pos + 2), len);
+            pos += 2 + len;
+        }
+        derived_.assign(n_cols, ColumnarAbsDiff{0, 0, 0});
+        is_derived_.assign(n_cols, 0);
+        if (!v1) {
+            need(pos + 4);
+            const std::size_t n_derived = detail::get_le<std::uint32_t>(data_ + pos);
+            pos += 4;
+            need(pos + 12 * n_derived);
+            for (std::size_t j = 0; j < n_derived; ++j, pos += 12) {
+                const ColumnarAbsDiff d{detail::get_le<std::uint32_t>(data_ + pos),
+                                        detail::get_le<std::uint32_t>(data_ + pos + 4),
+                                        detail::get_le<std::uint32_t>(data_ + pos + 8)};
+                if (d.column >= n_cols || d.minuend >= n_cols || d.subtrahend >= n_cols)
+                    throw std::runtime_error("ColumnarReader: corrupt derived column");
+                derived_[d.column] = d;
+                is_derived_[d.column] = 1;
+            }
+            for (std::size_t c = 0; c < n_cols; ++c)
+                if (is_derived_[c] && (is_derived_[derived_[c].minuend] || is_derived_[derived_[c].subtrahend]))
+                    throw std::runtime_error("ColumnarReader: corrupt derived column");
+        }
+        need(pos + 16 * n_cols * n_chunks_);
+        index_ = data_ + pos;
+    }
+    ~ColumnarReader() { if (data_) ::munmap(const_cast<std::uint8_t*>(data_), size_); }
+    ColumnarReader(const ColumnarReader&) = delete;
+    ColumnarReader& operator=(const ColumnarReader&) = delete;
+
+    std::size_t rows() const { return rows_; }
+    std::size_t chunk_rows() const { return chunk_rows_; }
+    std::size_t chunks() const { return n_chunks_; }
+    std::size_t file_bytes() const { return size_; }
+    const std::vector<std::string>& names() const { return names_; }
+
+    std::size_t column(const std::string& name) const {
+        const auto it = std::find(names_.begin(), names_.end(), name);
+        if (it == names_.end()) throw std::out_of_range("ColumnarReader: no column " + name);
+        return static_cast<std::size_t>(it - names_.begin());
+    }
+
+    bool is_derived(std::size_t c) const { return is_derived_[c] != 0; }
+
+    // Encoded bytes of column c (0 for a derived column).
+    std::uint64_t column_bytes(std::size_t c) const {
+        std::uint64_t total = 0;
+        for (std::size_t k = 0; k < n_chunks_; ++k) total += detail::get_le<std::uint64_t>(index_ + 16 * (c * n_chunks_ + k) + 8);
+        return total;
+    }
+
+    // Rows of chunk k of column c into out (chunk_rows values, fewer for the last chunk).
+    // A derived column decodes its two operands and recomputes |minuend - subtrahend|.
+    std::size_t read_chunk(std::size_t c, std::size_t k, double* out) const {
+        const std::size_t n = std::min<std::size_t>(chunk_rows_, rows_ - k * chunk_rows_);
+        if (is_derived_[c]) {
+            std::vector<double> b(n);
+            read_stored_chunk(derived_[c].minuend, k, out, n);
+            read_stored_chunk(derived_[c].subtrahend, k, b.data(), n);
+            for (std::size_t i = 0; i < n; ++i) out[i] = std::abs(out[i] - b[i]);
+            return n;
+        }
+        read_stored_chunk(c, k, out, n);
+        return n;
+    }
+
+    // Rows [first, first + count) of column c, decoding only the chunks they span.
+    void read_rows(std::size_t c, std::size_t first, std::size_t count, double* out) const {
+        if (first + count > rows_) throw std::out_of_range("ColumnarReader: rows out of range");
+        std::vector<double> tmp(chunk_rows_);
+        for (std::size_t row = first; row < first + count;) {
+            const std::size_t k = row / chunk_rows_, base = k * chunk_rows_;
+            const std::size_t n = read_chunk(c, k, tmp.data());
+            const std::size_t take = std::min(first + count, base + n) - row;
+            std::copy(tmp.begin() + (row - base), tmp.begin() + (row - base + take), out + (row - first));
+            row += take;
+        }
+    }
+
+    std::vector<double> read_column(std::size_t c, TaskScheduler& s = TaskScheduler::global()) const {
+        std::vector<double> out(rows_);
+        parallel_for(0, n_chunks_, 1, [&](std::size_t lo, std::size_t hi) {
+            for (std::size_t k = lo; k < hi; ++k) read_chunk(c, k, out.data() + k * chunk_rows_);
+        }, s);
+        return out;
+    }
+
+  private:
+    void read_stored_chunk(std::size_t c, std::size_t k, double* out, std::size_t n) const {
+        const std::uint8_t* e = index_ + 16 * (c * n_chunks_ + k);
+        const std::uint64_t off = detail::get_le<std::uint64_t>(e), bytes = detail::get_le<std::uint64_t>(e + 8);
+        if (off + bytes > size_) throw std::runtime_error("ColumnarReader: chunk out of range");
+        if (bytes < 4) throw std::runtime_error("ColumnarReader: corrupt chunk");
+        const std::uint32_t tag = detail::get_le<std::uint32_t>(data_ + off);
+        if (tag & columnar_shuffled) shuffle_decode(data_ + off + 4, bytes - 4, out, n, tag & ~columnar_shuffled);
+        else gorilla_decode(data_ + off + 4, bytes - 4, out, n, tag);
+    }
+
+    const std::uint8_t* data_ = nullptr;
+    const std::uint8_t* index_ = nullptr;
+    std::size_t size_ = 0, rows_ = 0, chunk_rows_ = 0, n_chunks_ = 0;
+    std::vector<std::string> names_;
+    std::vector<ColumnarAbsDiff> derived_;
+    std::vector<char> is_derived_;
+};
+
+} // namespace quant
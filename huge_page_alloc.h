@@ -0,0 +1,260 @@
+#pragma once
+/**
+ * @file huge_page_alloc.h
+ * @brief 2 MB page backing for large SoA arrays and MC buffers, plus fault/TLB counters.
+ *
+ * Exposes:
+ *  - PagePolicy:               Small (plain operator new), Transparent (madvise(MADV_HUGEPAGE)
+ *                              on a 2 MB-aligned mapping), Explicit (MAP_HUGETLB, falling back
+ *                              to Transparent when the hugetlb pool is empty).
+ *  - huge_page_alloc / huge_page_free: raw mappings.
+ *  - backed_page_policy(p):    the backing the kernel actually gave the mapping holding p,
+ *                              read from /proc/self/smaps (hugetlb pages, THP, or 4K).
+ *  - prefault(p, bytes):       write one byte per 4 KB page so first-touch faults happen
+ *                              before timing, not inside the kernel being measured.
+ *  - HugePageAllocator<T>, huge_vector<T>: std::vector over the above. Requests below
+ *                              huge_page_threshold go to operator new whatever the policy.
+ *  - huge_buffer_resize(v, n, policy): resize a (thread_local) scratch vector, rebinding it
+ *                              to `policy` first if it was created with another.
+ *  - PageFaultStats, page_fault_snapshot(): minor / major faults from getrusage.
+ *  - TlbMissCounter:           dTLB load misses via perf_event_open; available() is false
+ *                              where the kernel or perf_event_paranoid refuses the counter.
+ *
+ * Whether Transparent mappings really get 2 MB pages depends on
+ * /sys/kernel/mm/transparent_hugepage/enabled ("madvise" or "always"); otherwise they
+ * behave like ordinary anonymous memory. Nothing here is required for correctness.
+ * Off Linux (no hugetlb, THP, smaps or perf events) the mapped policies fall back to
+ * 2 MB-aligned operator new, backed_page_policy reports Small and TlbMissCounter is
+ * unavailable.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace quant {
+
+enum class PagePolicy { Small, Transparent, Explicit };
+
+inline constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+inline constexpr std::size_t huge_page_threshold = huge_page_size;   // smaller requests use operator new
+
+inline const char* page_policy_name(PagePolicy p) {
+    switch (p) {
+    case PagePolicy::Small:       return "4K";
+    case PagePolicy::Transparent: return "THP";
+    case PagePolicy::Explicit:    return "hugetlb";
+    }
+    return "";
+}
+
+namespace detail {
+
+inline std::size_t huge_round(std::size_t bytes) { return (bytes + huge_page_size - 1) & ~(huge_page_size - 1); }
+
+// Anonymous mapping of `len` bytes (a multiple of 2 MB) aligned to 2 MB: over-map by one
+// page and trim both ends, so khugepaged can back every 2 MB range.
+inline void* map_aligned(std::size_t len) {
+    void* raw = mmap(nullptr, len + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+    const std::uintptr_t a = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t p = (a + huge_page_size - 1) & ~(std::uintptr_t(huge_page_size) - 1);
+    if (p > a) munmap(raw, p - a);
+    if (const std::size_t tail = (a + len + huge_page_size) - (p + len)) munmap(reinterpret_cast<void*>(p + len), tail);
+    return reinterpret_cast<void*>(p);
+}
+
+} // namespace detail
+
+// Maps at least `bytes` (rounded to 2 MB) with the requested policy (Explicit degrades
+// to Transparent without a hugetlb pool; backed_page_policy tells which one held).
+// Returns nullptr on failure. Policy Small is not handled here: callers use operator new.
+inline void* huge_page_alloc(std::size_t bytes, PagePolicy policy) {
+    const std::size_t len = detail::huge_round(std::max<std::size_t>(bytes, 1));
+#ifndef __linux__
+    (void)policy;
+    return ::operator new(len, std::align_val_t(huge_page_size), std::nothrow);
+#else
+#ifdef MAP_HUGETLB
+    if (policy == PagePolicy::Explicit) {
+        void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) return p;
+    }
+#endif
+    void* p = detail::map_aligned(len);
+    if (!p) return nullptr;
+#ifdef MADV_HUGEPAGE
+    madvise(p, len, MADV_HUGEPAGE);
+#endif
+    return p;
+#endif
+}
+
+// Backing of the mapping holding `p` once touched: Explicit for hugetlb pages, Transparent
+// if any of it is on transparent huge pages, Small otherwise (also when smaps is unreadable).
+inline PagePolicy backed_page_policy(const void* p) {
+#ifndef __linux__
+    (void)p;
+    return PagePolicy::Small;
+#else
+    std::FILE* f = std::fopen("/proc/self/smaps", "r");
+    if (!f) return PagePolicy::Small;
+    const std::uintptr_t a = reinterpret_cast<std::uintptr_t>(p);
+    PagePolicy result = PagePolicy::Small;
+    bool inside = false;
+    char line[512];
+    while (std::fgets(line, sizeof(line), f)) {
+        unsigned long lo, hi, kb;
+        if (std::sscanf(line, "%lx-%lx ", &lo, &hi) == 2) {   // mapping header
+            if (inside) break;   // past the mapping
+            inside = a >= lo && a < hi;
+        } else if (inside && std::sscanf(line, "KernelPageSize: %lu kB", &kb) == 1 && kb >= 2048) {
+            result = PagePolicy::Explicit;
+            break;
+        } else if (inside && std::sscanf(line, "AnonHugePages: %lu kB", &kb) == 1 && kb > 0) {
+            result = PagePolicy::Transparent;
+        }
+    }
+    std::fclose(f);
+    return result;
+#endif
+}
+
+inline void huge_page_free(void* p, std::size_t bytes) {
+#ifndef __linux__
+    (void)bytes;
+    ::operator delete(p, std::align_val_t(huge_page_size), std::nothrow);
+#else
+    if (p) munmap(p, detail::huge_round(std::max<std::size_t>(bytes, 1)));
+#endif
+}
+
+inline void prefault(void* p, std::size_t bytes) {
+    volatile unsigned char* c = static_cast<unsigned char*>(p);
+    for (std::size_t off = 0; off < bytes; off += 4096) c[off] = c[off];
+}
+
+template <class T>
+class HugePageAllocator {
+  public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    HugePageAllocator(PagePolicy policy = PagePolicy::Transparent) noexcept : policy_(policy) {}
+    template <class U>
+    HugePageAllocator(const HugePageAllocator<U>& o) noexcept : policy_(o.policy()) {}
+
+    PagePolicy policy() const { return policy_; }
+
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+        const std::size_t bytes = n * sizeof(T);
+        if (!mapped(bytes)) return static_cast<T*>(::operator new(bytes, std::align_val_t(alignment)));
+        void* p = huge_page_alloc(bytes, policy_);
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        const std::size_t bytes = n * sizeof(T);
+        if (!mapped(bytes)) ::operator delete(p, std::align_val_t(alignment));
+        else huge_page_free(p, bytes);
+    }
+
+    template <class U>
+    bool operator==(const HugePageAllocator<U>& o) const { return policy_ == o.policy(); }
+    template <class U>
+    bool operator!=(const HugePageAllocator<U>& o) const { return policy_ != o.policy(); }
+
+  private:
+    static constexpr std::size_t alignment = std::max<std::size_t>(alignof(T), 64);
+    bool mapped(std::size_t bytes) const { return policy_ != PagePolicy::Small && bytes >= huge_page_threshold; }
+
+    PagePolicy policy_;
+};
+
+template <class T>
+using huge_vector = std::vector<T, HugePageAllocator<T>>;
+
+template <class T>
+void huge_buffer_resize(huge_vector<T>& v, std::size_t n, PagePolicy policy) {
+    if (v.get_allocator().policy() != policy) v = huge_vector<T>(HugePageAllocator<T>(policy));
+    v.resize(n);
+}
+
+struct PageFaultStats {
+    long minor = 0, major = 0;
+
+    PageFaultStats operator-(const PageFaultStats& o) const { return {minor - o.minor, major - o.major}; }
+};
+
+inline PageFaultStats page_fault_snapshot() {
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    return {ru.ru_minflt, ru.ru_majflt};
+}
+
+// Counts dTLB read misses of the calling thread between start() and stop().
+class TlbMissCounter {
+  public:
+    TlbMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~TlbMissCounter() { if (fd_ >= 0) close(fd_); }
+    TlbMissCounter(const TlbMissCounter&) = delete;
+    TlbMissCounter& operator=(const TlbMissCounter&) = delete;
+
+    bool available() const { return fd_ >= 0; }
+
+    void start() {
+#ifdef __linux__
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    // Misses since start(); 0 when unavailable.
+    std::uint64_t stop() {
+        if (fd_ < 0) return 0;
+#ifdef __linux__
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+        std::uint64_t count = 0;
+        if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) return 0;
+        return count;
+    }
+
+  private:
+    int fd_ = -1;
+};
+
+} // namespace quant
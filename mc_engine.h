@@ -0,0 +1,186 @@
+#pragma once
+/**
+ * @file mc_engine.h
+ * @brief Block-parallel Monte Carlo engine with a standard-error stopping rule.
+ *
+ * Exposes:
+ *  - WelfordStats:          running count / mean / M2 with Chan's pairwise merge.
+ *  - MCConfig, MCResult:    engine settings (block size, path budget, SE target) and output.
+ *  - mc_run(cfg, kernel):   scheduler tasks claim blocks of paths, publish per-block Welford
+ *                           statistics without locks, and stop cooperatively once the
+ *                           merged standard error reaches cfg.target_se.
+ *  - mc_run_multi(cfg, m, kernel): same engine for m estimators sharing one path set.
+ *  - fill_normals(seed, z, n): per-block standard normals (mt19937_64 + batch ICN).
+ *
+ * Per-thread path buffers are huge_vectors under cfg.pages, so large blocks (block_size ×
+ * dates ≥ 2 MB) sit on 2 MB pages.
+ *
+ * Blocks are merged strictly in index order and block b is seeded from (seed, b) alone,
+ * so the estimate and the stopping point do not depend on the thread count.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "InverseCumulativeNormal.h"
+#include "huge_page_alloc.h"
+#include "rqmc.h"
+#include "task_scheduler.h"
+
+namespace quant {
+
+struct WelfordStats {
+    double n = 0.0, mean = 0.0, m2 = 0.0;
+
+    inline void add(double x) {
+        n += 1.0;
+        const double delta = x - mean;
+        mean += delta / n;
+        m2 += delta * (x - mean);
+    }
+
+    // Chan et al. parallel combination
+    inline void merge(const WelfordStats& o) {
+        if (o.n == 0.0) return;
+        if (n == 0.0) { *this = o; return; }
+        const double tot = n + o.n;
+        const double delta = o.mean - mean;
+        mean += delta * (o.n / tot);
+        m2 += o.m2 + delta * delta * (n * o.n / tot);
+        n = tot;
+    }
+
+    double variance() const { return n > 1.0 ? m2 / (n - 1.0) : 0.0; }
+    double std_error() const { return n > 1.0 ? std::sqrt(variance() / n) : 0.0; }
+};
+
+struct MCConfig {
+    std::size_t block_size = 4096;           // paths per block (the unit of work and of checking)
+    std::size_t max_paths  = std::size_t(1) << 20;
+    std::size_t min_paths  = std::size_t(1) << 14;
+    double target_se       = 0.0;            // <= 0: always run max_paths
+    unsigned threads       = 0;              // concurrent block claimers; 0 = scheduler size
+    std::uint64_t seed     = 42;
+    const std::atomic<bool>* cancel = nullptr;  // optional external cancellation token
+    PagePolicy pages       = PagePolicy::Transparent;  // per-thread path buffers of >= 2 MB
+};
+
+struct MCResult {
+    double mean;
+    double std_error;
+    std::size_t paths;       // paths in the reported estimate
+    std::size_t blocks;      // blocks in the reported estimate
+    bool converged;          // std_error <= target_se
+};
+
+// Standard normals for one block: uniforms from mt19937_64(seed) through the batch ICN.
+inline void fill_normals(std::uint64_t seed, double* z, std::size_t n) {
+    std::mt19937_64 rng(seed);
+    for (std::size_t i = 0; i < n; ++i) z[i] = (static_cast<double>(rng() >> 11) + 0.5) * 0x1p-53;
+    const InverseCumulativeNormal icn;
+    icn(z, z, n);
+}
+
+struct MCMultiResult {
+    std::vector<double> mean;
+    std::vector<double> std_error;
+    std::size_t paths;
+    std::size_t blocks;
+    bool converged;          // max std_error <= target_se
+};
+
+// Several estimators driven by the same paths. kernel(std::uint64_t block_seed,
+// WelfordStats* stats, std::size_t n) simulates n paths and accumulates into
+// stats[0..n_outputs), which arrive zeroed. The stopping rule uses the largest
+// standard error over all outputs.
+template <class BlockKernel>
+MCMultiResult mc_run_multi(const MCConfig& cfg, std::size_t n_outputs, BlockKernel&& kernel) {
+    const std::size_t B = std::max<std::size_t>(cfg.block_size, 2);
+    const std::size_t n_blocks = std::max<std::size_t>((cfg.max_paths + B - 1) / B, 1);
+    const std::size_t min_blocks = std::min(n_blocks, std::max<std::size_t>((cfg.min_paths + B - 1) / B, 1));
+    unsigned threads = cfg.threads ? cfg.threads : TaskScheduler::global().size();
+    threads = static_cast<unsigned>(std::min<std::size_t>(std::max(threads, 1u), n_blocks));
+
+    struct Slot {
+        std::unique_ptr<WelfordStats[]> stats;
+        std::atomic<bool> ready{false};
+    };
+    std::unique_ptr<Slot[]> slots(new Slot[n_blocks]);
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> stop{false};
+    std::atomic<bool> merging{false};
+    std::size_t merged = 0;          // owned by whoever holds `merging`
+    std::vector<WelfordStats> total(n_outputs);
+    bool converged = false;
+
+    auto external_cancel = [&] { return cfg.cancel && cfg.cancel->load(std::memory_order_relaxed); };
+
+    // Folds the ready prefix into `total`, stopping at the first prefix that meets the target.
+    auto advance = [&] {
+        while (!converged && merged < n_blocks && slots[merged].ready.load(std::memory_order_acquire)) {
+            double worst = 0.0;
+            for (std::size_t k = 0; k < n_outputs; ++k) {
+                total[k].merge(slots[merged].stats[k]);
+                worst = std::max(worst, total[k].std_error());
+            }
+            slots[merged].stats.reset();
+            ++merged;
+            if (cfg.target_se > 0.0 && merged >= min_blocks && worst <= cfg.target_se) {
+                converged = true;
+                stop.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    auto worker = [&] {
+        for (;;) {
+            if (stop.load(std::memory_order_relaxed) || external_cancel()) break;
+            const std::size_t b = next.fetch_add(1, std::memory_order_relaxed);
+            if (b >= n_blocks) break;
+            slots[b].stats.reset(new WelfordStats[n_outputs]);
+            kernel(splitmix64(cfg.seed + b), slots[b].stats.get(), B);
+            slots[b].ready.store(true, std::memory_order_release);
+            if (!merging.exchange(true, std::memory_order_acquire)) {
+                advance();
+                merging.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    // Claimers run on the shared scheduler; the caller claims too while it waits.
+    TaskGroup group;
+    for (unsigned t = 1; t < threads; ++t) group.run(worker);
+    worker();
+    group.wait();
+    advance();  // blocks published while another thread held `merging`
+
+    MCMultiResult res{std::vector<double>(n_outputs), std::vector<double>(n_outputs), merged * B, merged, converged};
+    for (std::size_t k = 0; k < n_outputs; ++k) {
+        res.mean[k] = total[k].mean;
+        res.std_error[k] = total[k].std_error();
+    }
+    return res;
+}
+
+// kernel(std::uint64_t block_seed, double* payoffs, std::size_t n) writes n path payoffs.
+template <class BlockKernel>
+MCResult mc_run(const MCConfig& cfg, BlockKernel&& kernel) {
+    const std::size_t B = std::max<std::size_t>(cfg.block_size, 2);
+    auto stats_kernel = [&](std::uint64_t seed, WelfordStats* stats, std::size_t n) {
+        thread_local huge_vector<double> payoff;
+        huge_buffer_resize(payoff, B, cfg.pages);
+        kernel(seed, payoff.data(), n);
+        for (std::size_t i = 0; i < n; ++i) stats->add(payoff[i]);
+    };
+    const MCMultiResult r = mc_run_multi(cfg, 1, stats_kernel);
+    return {r.mean[0], r.std_error[0], r.paths, r.blocks, r.converged};
+}
+
+} // namespace quant
@@ -0,0 +1,106 @@
+#pragma once
+/**
+ * @file mc_term_strip.h
+ * @brief Shared-path Monte Carlo for a term structure of European calls.
+ *
+ * Exposes:
+ *  - StripExpiry:        one expiry date with its strikes.
+ *  - mc_price_strip(...): simulates GBM once on the union of expiry dates (exact
+ *                        log-normal steps between consecutive dates) and evaluates every
+ *                        (expiry, strike) payoff on the same paths. Only the running
+ *                        Welford sums per output are kept, never the paths themselves.
+ *
+ * Results are ordered as the input: expiry by expiry, strikes in the given order.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mc_engine.h"
+
+namespace quant {
+
+struct StripExpiry {
+    double T;
+    std::vector<double> strikes;
+};
+
+struct StripQuote {
+    double T, K;
+    double price;
+    double std_error;
+};
+
+struct StripResult {
+    std::vector<StripQuote> quotes;
+    std::size_t paths;
+    bool converged;
+};
+
+inline StripResult mc_price_strip(double S, double r, double q, double sigma,
+                                  const std::vector<StripExpiry>& expiries, const MCConfig& cfg = {}) {
+    // Union of expiry dates, and for each output the date index it is evaluated at.
+    std::vector<double> dates;
+    for (const StripExpiry& e : expiries) dates.push_back(e.T);
+    std::sort(dates.begin(), dates.end());
+    dates.erase(std::unique(dates.begin(), dates.end()), dates.end());
+    const std::size_t n_dates = dates.size();
+
+    struct Output { std::size_t date; double K; };
+    std::vector<Output> outputs;
+    std::vector<std::size_t> first_output(n_dates + 1, 0);   // outputs grouped by date
+    for (std::size_t d = 0; d < n_dates; ++d) {
+        first_output[d] = outputs.size();
+        for (const StripExpiry& e : expiries)
+            if (e.T == dates[d])
+                for (double K : e.strikes) outputs.push_back({d, K});
+    }
+    first_output[n_dates] = outputs.size();
+
+    // Per-step drift and diffusion, per-date discount factors.
+    std::vector<double> drift(n_dates), vol(n_dates), DF(n_dates);
+    double prev = 0.0;
+    for (std::size_t d = 0; d < n_dates; ++d) {
+        const double dt = dates[d] - prev;
+        drift[d] = (r - q - 0.5 * sigma * sigma) * dt;
+        vol[d]   = sigma * std::sqrt(dt);
+        DF[d]    = std::exp(-r * dates[d]);
+        prev = dates[d];
+    }
+
+    const std::size_t B = std::max<std::size_t>(cfg.block_size, 2);
+    auto kernel = [&](std::uint64_t seed, WelfordStats* stats, std::size_t n) {
+        thread_local huge_vector<double> z;
+        huge_buffer_resize(z, B * n_dates, cfg.pages);
+        fill_normals(seed, z.data(), n * n_dates);
+        for (std::size_t p = 0; p < n; ++p) {
+            const double* zp = z.data() + p * n_dates;
+            double lnS = std::log(S);
+            for (std::size_t d = 0; d < n_dates; ++d) {
+                lnS += drift[d] + vol[d] * zp[d];
+                const double ST = std::exp(lnS);
+                for (std::size_t k = first_output[d]; k < first_output[d + 1]; ++k)
+                    stats[k].add(DF[d] * std::max(ST - outputs[k].K, 0.0));
+            }
+        }
+    };
+    const MCMultiResult mc = mc_run_multi(cfg, outputs.size(), kernel);
+
+    // Back to input order.
+    StripResult res{{}, mc.paths, mc.converged};
+    for (const StripExpiry& e : expiries) {
+        const std::size_t d = static_cast<std::size_t>(
+            std::lower_bound(dates.begin(), dates.end(), e.T) - dates.begin());
+        for (double K : e.strikes) {
+            std::size_t k = first_output[d];
+            while (outputs[k].K != K) ++k;
+            res.quotes.push_back({e.T, K, mc.mean[k], mc.std_error[k]});
+        }
+    }
+    return res;
+}
+
+} // namespace quant
@@ -0,0 +1,153 @@
+#pragma once
+/**
+ * @file merton_jump.h
+ * @brief Merton (1976) jump-diffusion call: Poisson-weighted Black–Scholes series.
+ *
+ * Exposes:
+ *  - MertonParams:                  jump intensity λ, mean log-jump μ_J, log-jump vol δ.
+ *  - merton_price_call(...):        series summed 8 terms at a time through
+ *                                   bs_price_call_batch, truncated adaptively per option.
+ *  - merton_price_call_batch(...):  the same over SoA option arrays.
+ *  - merton_price_call_t<T>(...):   fixed-length series on bs_price_call_t (complex-step).
+ *  - merton_cs_greeks(...):         delta, gamma (45°), vega by complex step.
+ *
+ * With κ = exp(μ_J + δ²/2) - 1 and λ' = λ(1+κ), term n is
+ *   e^{-λ'T}(λ'T)^n/n! · BS(S, K, r - λκ + n ln(1+κ)/T, q, sqrt(σ² + nδ²/T), T).
+ * Every BS term is bounded by S e^{-qT}, so the series stops once the remaining
+ * Poisson mass times that bound drops below tol·S. At or past expiry (T <= 0) no
+ * jump can arrive and the price is bs_price_call's intrinsic value.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+
+#include "bs_batch.h"
+#include "bs_complex_step.h"
+
+namespace quant {
+
+struct MertonParams {
+    double lambda;   // jumps per year
+    double mu_j;     // mean of log jump size
+    double delta;    // std of log jump size
+};
+
+struct MertonPrice {
+    double price;
+    std::size_t terms;   // series terms evaluated
+};
+
+inline constexpr std::size_t merton_lanes = 8;
+inline constexpr std::size_t merton_max_terms = 512;
+
+inline MertonPrice merton_price_call(double S, double K, double r, double q, double sigma, double T,
+                                     const MertonParams& jp, double tol = 1e-16) {
+    // The n-th term's rate and variance shifts divide by T.
+    if (T <= 0.0) return {bs_price_call(S, K, r, q, sigma, T), 1};
+
+    const double kappa  = std::expm1(jp.mu_j + 0.5 * jp.delta * jp.delta);
+    const double lamT   = jp.lambda * (1.0 + kappa) * T;
+    const double r_base = r - jp.lambda * kappa;
+    const double r_step = std::log1p(kappa) / T;
+    const double v_step = jp.delta * jp.delta / T;
+    const double bound  = S * std::exp(-q * T);
+
+    double S_l[merton_lanes], K_l[merton_lanes], r_l[merton_lanes], q_l[merton_lanes];
+    double v_l[merton_lanes], T_l[merton_lanes], w_l[merton_lanes], c_l[merton_lanes];
+    std::fill(S_l, S_l + merton_lanes, S);
+    std::fill(K_l, K_l + merton_lanes, K);
+    std::fill(q_l, q_l + merton_lanes, q);
+    std::fill(T_l, T_l + merton_lanes, T);
+
+    double w = std::exp(-lamT);   // Poisson weight of the next term
+    double sum = 0.0;
+    std::size_t n = 0;
+    while (n < merton_max_terms) {
+        for (std::size_t l = 0; l < merton_lanes; ++l) {
+            const double nn = static_cast<double>(n + l);
+            r_l[l] = r_base + nn * r_step;
+            v_l[l] = std::sqrt(sigma * sigma + nn * v_step);
+            w_l[l] = w;
+            w *= lamT / (nn + 1.0);
+        }
+        bs_price_call_batch(S_l, K_l, r_l, q_l, v_l, T_l, c_l, merton_lanes);
+        for (std::size_t l = 0; l < merton_lanes; ++l) {
+            sum += w_l[l] * c_l[l];
+        }
+        n += merton_lanes;
+        // Remaining Poisson mass: geometric bound once past the mode.
+        const double nn = static_cast<double>(n);
+        if (nn + 1.0 > lamT && w / (1.0 - lamT / (nn + 1.0)) * bound <= tol * S) break;
+    }
+    return {sum, n};
+}
+
+inline void merton_price_call_batch(const double* S, const double* K, const double* r, const double* q,
+                                    const double* sigma, const double* T, const MertonParams& jp,
+                                    double* out, std::size_t n, double tol = 1e-16) {
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = merton_price_call(S[i], K[i], r[i], q[i], sigma[i], T[i], jp, tol).price;
+}
+
+// Fixed-length series through the templated pricer (terms from merton_price_call).
+template <class T>
+T merton_price_call_t(T S, T K, T r, T q, T sigma, T Tmat, const MertonParams& jp, std::size_t terms) {
+    using std::exp; using std::log; using std::sqrt;
+
+    const double kappa = std::expm1(jp.mu_j + 0.5 * jp.delta * jp.delta);
+    const T lamT = T(jp.lambda * (1.0 + kappa)) * Tmat;
+    T w = exp(-lamT);
+    T sum = T(0.0);
+    for (std::size_t n = 0; n < terms; ++n) {
+        const double nn = static_cast<double>(n);
+        const T r_n = r - T(jp.lambda * kappa) + T(nn * std::log1p(kappa)) / Tmat;
+        const T v_n = sqrt(sigma * sigma + T(nn * jp.delta * jp.delta) / Tmat);
+        if (std::real(v_n) == 0.0) {
+            // No-jump term at σ = 0: the discounted forward payoff (bs_price_call's sigmaT == 0 case)
+            const T F = S * exp((r_n - q) * Tmat);
+            sum += w * (std::real(F) > std::real(K) ? exp(-r_n * Tmat) * (F - K) : T(0.0));
+        } else {
+            sum += w * bs_price_call_t(S, K, r_n, q, v_n, Tmat);
+        }
+        w *= lamT / T(nn + 1.0);
+    }
+    return sum;
+}
+
+struct MertonGreeks {
+    double price;
+    double delta;
+    double gamma;    // 45-degree complex step
+    double vega;
+    std::size_t terms;
+};
+
+inline MertonGreeks merton_cs_greeks(double S, double K, double r, double q, double sigma, double T,
+                                     const MertonParams& jp, double h_rel_gamma = 1e-4) {
+    using C = std::complex<double>;
+    const MertonPrice base = merton_price_call(S, K, r, q, sigma, T, jp);
+    const std::size_t N = base.terms;
+    if (T <= 0.0) {
+        const double F = S * std::exp((r - q) * T);
+        return {base.price, F > K ? std::exp(-q * T) : 0.0, 0.0, 0.0, N};
+    }
+
+    const double h1 = 1e-20 * S;
+    const double hv = 1e-20 * std::max(sigma, 1.0);
+    const double h2 = h_rel_gamma * S;
+    const C omega(1.0 / std::sqrt(2.0), 1.0 / std::sqrt(2.0));
+
+    MertonGreeks g;
+    g.price = base.price;
+    g.terms = N;
+    g.delta = merton_price_call_t<C>(C(S, h1), K, r, q, sigma, T, jp, N).imag() / h1;
+    g.vega  = merton_price_call_t<C>(S, K, r, q, C(sigma, hv), T, jp, N).imag() / hv;
+    const C up = merton_price_call_t<C>(S + h2 * omega, K, r, q, sigma, T, jp, N);
+    const C dn = merton_price_call_t<C>(S - h2 * omega, K, r, q, sigma, T, jp, N);
+    g.gamma = (up + dn).imag() / (h2 * h2);
+    return g;
+}
+
+} // namespace quant
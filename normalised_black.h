@@ -0,0 +1,227 @@
+#pragma once
+/**
+ * @file normalised_black.h
+ * @brief Normalised Black function b(x, s) with per-regime kernels and a partitioned batch.
+ *
+ * Exposes:
+ *  - BlackRegime, black_regime(x, s):  which formulation a (x, s) pair takes.
+ *  - normalised_black(x, s):           b(x, s) for one pair (dispatches on the regime).
+ *  - normalised_black_batch(x, s, b, n): regime-partitioned batch.
+ *  - black_price_call_batch(...):      SoA call prices through the normalised core.
+ *  - normalised_implied_vol(x, b), black_implied_vol_call(...), black_implied_vol_call_batch(...):
+ *                                      inverse in s by safeguarded Newton (bisection fallback).
+ *
+ * With x = ln(F/K), s = σ√T (Jäckel's normalisation),
+ *   b(x, s) = e^{x/2}·Φ(x/s + s/2) − e^{−x/2}·Φ(x/s − s/2),   C = DF·√(FK)·b.
+ * Regimes:
+ *  - Intrinsic: s == 0, b = max(2 sinh(x/2), 0).
+ *  - SmallVol:  s ≤ 0.1, |x/s| ≤ 1 — the erfc-free series of bs_small_vol_terms.
+ *  - Tail:      d1 = x/s + s/2 ≤ −8 (deep OTM). With Y(z) = Φ(z)/φ(z),
+ *                 b = φ(x/s)·e^{−s²/8}·[Y(d1) − Y(d2)],
+ *               Y from the even part of the Mills-ratio continued fraction, 7 levels
+ *               in u = 1/t², summed forward with one division; no underflow of Φ, no erfc.
+ *  - General:   the two-Φ form.
+ * The batch runs in 64-lane chunks. A chunk whose lanes share a regime goes straight
+ * through that regime's branch-free kernel; a mixed chunk is split into per-regime lane
+ * lists, gathered, priced and scattered back, so it pays for each lane once.
+ *
+ * On a shuffled mixed book (bs_benchmark normalised_black: a quarter deep-OTM tail,
+ * a fifth small-vol) black_price_call_batch runs at about the speed of
+ * bs_price_call_batch; an earlier 24-deep, division-bound tail kernel held it to 0.75x.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "bs_batch.h"
+#include "bs_call_price.h"
+
+namespace quant {
+
+enum class BlackRegime : std::uint8_t { Intrinsic, SmallVol, Tail, General };
+inline constexpr std::size_t black_regime_count = 4;
+inline constexpr double black_tail_d1 = -8.0;
+
+inline BlackRegime black_regime(double x, double s) {
+    if (!(s > 0.0)) return BlackRegime::Intrinsic;
+    const double d1 = x / s + 0.5 * s;
+    if (bs_small_vol_regime(s, d1)) return BlackRegime::SmallVol;
+    if (d1 <= black_tail_d1) return BlackRegime::Tail;
+    return BlackRegime::General;
+}
+
+namespace detail {
+
+// Y(z) = Φ(z)/φ(z) for z ≤ −8. With t = −z and u = 1/t², the even contraction of the
+// Mills-ratio fraction 1/(t + 1/(t + 2/(t + ...))) is
+//   Y = (1/t) / (1 + u − 1·2u²/(1 + 5u − 3·4u²/(1 + 9u − ...))),
+// which at 7 levels is within 1e-15 for t ≥ 8. It is summed with the forward recurrence
+// (all terms O(1), no overflow for any t), so the only divisions are 1/t and the last.
+inline double black_mills_ratio(double z) {
+    const double t = -z, u = 1.0 / (t * t);
+    double A0 = 1.0, A1 = 1.0 + u, B0 = 0.0, B1 = 1.0;
+    for (int k = 1; k <= 7; ++k) {
+        const double a = -(2.0 * k - 1.0) * (2.0 * k) * u * u, b = 1.0 + (4.0 * k + 1.0) * u;
+        const double A2 = b * A1 + a * A0, B2 = b * B1 + a * B0;
+        A0 = A1; A1 = A2; B0 = B1; B1 = B2;
+    }
+    return B1 / (t * A1);
+}
+
+// Branch-free regime kernels over gathered (x, s) lanes.
+inline void black_kernel_intrinsic(const double* x, double* b, std::size_t m) {
+    for (std::size_t i = 0; i < m; ++i) b[i] = std::max(2.0 * std::sinh(0.5 * x[i]), 0.0);
+}
+
+inline void black_kernel_small_vol(const double* x, const double* s, double* b, std::size_t m) {
+    double Ph[bs_batch_chunk], ph[bs_batch_chunk], odd[bs_batch_chunk], even[bs_batch_chunk];
+    for (std::size_t i = 0; i < m; ++i)
+        bs_small_vol_series(s[i], x[i] / s[i] + 0.5 * s[i], Ph[i], ph[i], odd[i], even[i]);
+    for (std::size_t i = 0; i < m; ++i) {
+        // √(FK)·b with F = e^{x/2}, K = e^{−x/2}: (F − K) = 2 sinh(x/2), (F + K) = 2 cosh(x/2),
+        // both from one expm1 (e^{x/2} = 1 + em) without cancellation near the money
+        const double em = std::expm1(0.5 * x[i]), e = 1.0 + em;
+        const double sh = em * (2.0 + em) / e;
+        const double ch = e + 1.0 / e;
+        b[i] = sh * Ph[i] + ph[i] * (ch * odd[i] - sh * even[i]);
+    }
+}
+
+inline void black_kernel_tail(const double* x, const double* s, double* b, std::size_t m) {
+    for (std::size_t i = 0; i < m; ++i) {
+        const double h = x[i] / s[i];
+        const double d1 = h + 0.5 * s[i];
+        const double d2 = h - 0.5 * s[i];
+        // φ(h)·e^{−s²/8} = e^{−(d1² + d2²)/4}/√(2π), one exp
+        const double scale = 0.39894228040143267794 * std::exp(-0.25 * (d1 * d1 + d2 * d2));
+        b[i] = scale * (black_mills_ratio(d1) - black_mills_ratio(d2));
+    }
+}
+
+inline void black_kernel_general(const double* x, const double* s, double* b, std::size_t m) {
+    for (std::size_t i = 0; i < m; ++i) {
+        const double d1 = x[i] / s[i] + 0.5 * s[i];
+        const double e = std::exp(0.5 * x[i]);
+        b[i] = e * Phi_real(d1) - Phi_real(d1 - s[i]) / e;
+    }
+}
+
+inline void black_kernel(BlackRegime regime, const double* x, const double* s, double* b, std::size_t m) {
+    switch (regime) {
+    case BlackRegime::Intrinsic: black_kernel_intrinsic(x, b, m); break;
+    case BlackRegime::SmallVol:  black_kernel_small_vol(x, s, b, m); break;
+    case BlackRegime::Tail:      black_kernel_tail(x, s, b, m); break;
+    case BlackRegime::General:   black_kernel_general(x, s, b, m); break;
+    }
+}
+
+} // namespace detail
+
+inline double normalised_black(double x, double s) {
+    double b;
+    detail::black_kernel(black_regime(x, s), &x, &s, &b, 1);
+    return b;
+}
+
+namespace detail {
+
+// One chunk (m ≤ bs_batch_chunk lanes): a single-regime chunk runs its kernel in place,
+// a mixed one is split into per-regime lane lists that are gathered, priced and scattered.
+inline void normalised_black_chunk(const double* x, const double* s, double* b, std::size_t m) {
+    unsigned char regime[bs_batch_chunk];
+    std::size_t count[black_regime_count] = {};
+    for (std::size_t i = 0; i < m; ++i) {
+        regime[i] = static_cast<unsigned char>(black_regime(x[i], s[i]));
+        ++count[regime[i]];
+    }
+    for (std::size_t r = 0; r < black_regime_count; ++r)
+        if (count[r] == m) return black_kernel(static_cast<BlackRegime>(r), x, s, b, m);
+
+    unsigned char lanes[bs_batch_chunk];
+    double xg[bs_batch_chunk], sg[bs_batch_chunk], bg[bs_batch_chunk];
+    for (std::size_t r = 0; r < black_regime_count; ++r) {
+        if (count[r] == 0) continue;
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < m; ++i) {
+            lanes[k] = static_cast<unsigned char>(i);
+            k += regime[i] == r;
+        }
+        for (std::size_t j = 0; j < k; ++j) {
+            xg[j] = x[lanes[j]];
+            sg[j] = s[lanes[j]];
+        }
+        black_kernel(static_cast<BlackRegime>(r), xg, sg, bg, k);
+        for (std::size_t j = 0; j < k; ++j) b[lanes[j]] = bg[j];
+    }
+}
+
+} // namespace detail
+
+// b[i] = b(x[i], s[i]), in chunks of bs_batch_chunk lanes.
+inline void normalised_black_batch(const double* x, const double* s, double* b, std::size_t n) {
+    for (std::size_t base = 0; base < n; base += bs_batch_chunk)
+        detail::normalised_black_chunk(x + base, s + base, b + base, std::min(bs_batch_chunk, n - base));
+}
+
+// Call prices through the normalised core: C = DF·√(FK)·b(ln(F/K), σ√T).
+inline void black_price_call_batch(const double* S, const double* K, const double* r, const double* q,
+                                   const double* sigma, const double* T, double* out, std::size_t n) {
+    double x[bs_batch_chunk], s[bs_batch_chunk], scale[bs_batch_chunk];
+    for (std::size_t base = 0; base < n; base += bs_batch_chunk) {
+        const std::size_t m = std::min(bs_batch_chunk, n - base);
+        for (std::size_t i = 0; i < m; ++i) {
+            const std::size_t j = base + i;
+            const double DF = std::exp(-r[j] * T[j]);
+            const double F  = S[j] * std::exp((r[j] - q[j]) * T[j]);
+            x[i]     = detail::bs_log_moneyness(F, K[j]);
+            s[i]     = sigma[j] * std::sqrt(std::max(T[j], 0.0));
+            scale[i] = DF * std::sqrt(F * K[j]);
+        }
+        detail::normalised_black_chunk(x, s, out + base, m);
+        for (std::size_t i = 0; i < m; ++i) out[base + i] *= scale[i];
+    }
+}
+
+// s ≥ 0 with b(x, s) = beta. b is increasing in s with ∂b/∂s = e^{x/2}·φ(x/s + s/2), from
+// the intrinsic value at s = 0 to e^{x/2} as s → ∞; NaN outside that range. Newton steps
+// that leave the current bracket are replaced by bisection.
+inline double normalised_implied_vol(double x, double beta, double tol = 1e-14, int max_iter = 100) {
+    const double intrinsic = std::max(2.0 * std::sinh(0.5 * x), 0.0);
+    const double ex = std::exp(0.5 * x);
+    if (!(beta >= intrinsic) || !(beta < ex)) return std::numeric_limits<double>::quiet_NaN();
+    if (beta == intrinsic) return 0.0;
+
+    double lo = 0.0, hi = 1.0;
+    while (normalised_black(x, hi) < beta && hi < 64.0) { lo = hi; hi *= 2.0; }
+    double s = std::max(std::sqrt(2.0 * M_PI) * beta, std::sqrt(2.0 * std::abs(x)));
+    if (!(s > lo && s < hi)) s = 0.5 * (lo + hi);
+    for (int it = 0; it < max_iter; ++it) {
+        const double f = normalised_black(x, s) - beta;
+        if (f == 0.0) return s;
+        if (f < 0.0) lo = s; else hi = s;
+        const double vega = ex * phi(x / s + 0.5 * s);
+        double next = s - f / vega;
+        if (!(next > lo && next < hi)) next = 0.5 * (lo + hi);
+        if (std::abs(next - s) <= tol * s) return next;
+        s = next;
+    }
+    return s;
+}
+
+inline double black_implied_vol_call(double price, double S, double K, double r, double q, double T) {
+    if (!(T > 0.0)) return std::numeric_limits<double>::quiet_NaN();
+    const double DF = std::exp(-r * T);
+    const double F  = S * std::exp((r - q) * T);
+    const double s  = normalised_implied_vol(detail::bs_log_moneyness(F, K), price / (DF * std::sqrt(F * K)));
+    return s / std::sqrt(T);
+}
+
+inline void black_implied_vol_call_batch(const double* price, const double* S, const double* K, const double* r,
+                                         const double* q, const double* T, double* sigma, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) sigma[i] = black_implied_vol_call(price[i], S[i], K[i], r[i], q[i], T[i]);
+}
+
+} // namespace quant
@@ -0,0 +1,392 @@
+#pragma once
+/**
+ * @file result_cache.h
+ * @brief Persistent content-addressed cache of fixed-width double results in a
+ *        memory-mapped open-addressing hash table file.
+ *
+ * Exposes:
+ *  - CacheKey, cache_key(method, version, inputs, n): 128-bit key of a computation, hashed
+ *                       from the method name, its kernel version and the raw input bits.
+ *  - ResultCache(path, width, expected_entries): opens or creates the table, sized so that
+ *                       expected_entries fit without growing; lookup(key, out) copies the
+ *                       `width` cached values, insert(key, values) adds or overwrites them.
+ *                       hits() / misses() count lookups, flush() msyncs to disk.
+ *  - h_grid_cache_width(max_steps): record width of one scenario with room for max_steps steps.
+ *  - cached_greeks_h_grid(cache, S,K,r,q,σ,T, h, steps_computed): compute_greeks_h_grid with
+ *                       one record per scenario holding its steps.
+ *
+ * Keys are the identity of a result, so anything that changes the numbers (inputs, method,
+ * kernel version) misses and anything else hits: a rerun after an unrelated change costs
+ * one lookup per scenario, and a sweep over partly changed scenarios computes only the
+ * changed ones. A grid point costs less to price than to look up on its own, so the unit
+ * of caching is the scenario: its record is a small open-addressing table from h (by bit
+ * pattern) to that step's five values. Looking a grid up is one table probe; a finer or
+ * wider grid over the same scenario prices only the steps the record lacks.
+ *
+ * The table grows by doubling at 3/4 load: entries are rehashed into "<path>.tmp", which
+ * is synced and renamed over the old file, so the file on disk is always a whole table.
+ * Growth costs a full copy and sync, so callers that know their scenario count pass it as
+ * expected_entries and the table is created (or grown once, on reopen) at that size.
+ * Every entry carries a checksum of its key and values: the kernel writes back dirty
+ * pages in any order, so an entry torn by a crash fails the check, counts as a miss and
+ * is recomputed. An exclusive flock makes one process the owner; a second opener gets
+ * std::runtime_error. Lookups share a reader lock and run concurrently; inserts and
+ * growth take it exclusively.
+ *
+ * File layout (native endian): "QRCH0003" | u32 width | u32 0 | u64 capacity | u64 used |
+ * 32 bytes reserved | capacity × (u64 key hi, u64 key lo, u64 checksum, width doubles).
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bs_greeks.h"
+#include "rqmc.h"
+#include "sweep_engine.h"
+
+namespace quant {
+
+struct CacheKey {
+    std::uint64_t hi = 0, lo = 0;
+    bool operator==(const CacheKey& o) const { return hi == o.hi && lo == o.lo; }
+};
+
+// One 64-bit word into a running hash (xor-multiply-xorshift); finalise with splitmix64.
+inline std::uint64_t cache_mix(std::uint64_t h, std::uint64_t w) {
+    h = (h ^ w) * 0x9fb21c651e98df25ull;
+    return h ^ (h >> 29);
+}
+
+inline CacheKey cache_key(std::string_view method, std::uint32_t version, const double* inputs, std::size_t n) {
+    std::uint64_t h = fnv1a64(method);
+    h = fnv1a64({reinterpret_cast<const char*>(&version), sizeof(version)}, h);
+    // Second, independent half: the bytes again from another basis.
+    std::uint64_t g = fnv1a64(method, 0x84222325cbf29ce4ull);
+    g = fnv1a64({reinterpret_cast<const char*>(&version), sizeof(version)}, g);
+    g = splitmix64(g);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint64_t w;
+        std::memcpy(&w, inputs + i, 8);
+        h = cache_mix(h, w);
+        g = cache_mix(g, w + 0x632be59bd9b4e019ull);
+    }
+    CacheKey k{splitmix64(h), splitmix64(g ^ n)};
+    if (k.hi == 0 && k.lo == 0) k.lo = 1;   // all-zero marks an empty slot
+    return k;
+}
+
+inline constexpr char cache_magic[8] = {'Q', 'R', 'C', 'H', '0', '0', '0', '3'};
+
+class ResultCache {
+  public:
+    ResultCache(const std::string& path, std::uint32_t width, std::size_t expected_entries = 3000)
+        : path_(path), width_(width) {
+        if (width == 0) throw std::invalid_argument("ResultCache: width must be positive");
+        std::uint64_t cap = 16;
+        while (4 * (expected_entries + 1) > 3 * cap) cap <<= 1;
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) throw std::runtime_error("ResultCache: cannot open " + path);
+        if (::flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("ResultCache: " + path + " is in use by another process");
+        }
+        try {
+            struct stat st;
+            if (::fstat(fd_, &st) != 0) fail("cannot stat " + path);
+            if (st.st_size == 0) create(fd_, cap);
+            map();
+            const std::uint64_t c = capacity();
+            if (std::memcmp(base_, cache_magic, 8) != 0 || header_u32(8) != width_ || c == 0 || (c & (c - 1)) != 0
+                || file_bytes(c) != map_bytes_)
+                fail(path + " is not a result cache of width " + std::to_string(width_));
+            if (c < cap) grow(cap);
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    ~ResultCache() { release(); }
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    std::uint32_t width() const { return width_; }
+    std::uint64_t capacity() const { return header_u64(16); }
+    std::uint64_t size() const { return header_u64(24); }
+    std::uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    std::uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+    bool lookup(const CacheKey& key, double* out) {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const unsigned char* slot = find(key);
+        std::uint64_t sum;
+        std::memcpy(&sum, slot + 16, 8);
+        if (!occupied(slot) || sum != checksum(key, slot + 24)) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        std::memcpy(out, slot + 24, width_ * sizeof(double));
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void insert(const CacheKey& key, const double* values) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (4 * (size() + 1) > 3 * capacity()) grow(2 * capacity());
+        unsigned char* slot = find(key);
+        const bool fresh = !occupied(slot);
+        std::memcpy(slot + 24, values, width_ * sizeof(double));
+        const std::uint64_t sum = checksum(key, slot + 24);
+        std::memcpy(slot + 16, &sum, 8);
+        if (fresh) {
+            std::memcpy(slot + 8, &key.lo, 8);
+            std::memcpy(slot, &key.hi, 8);
+            set_header_u64(24, size() + 1);
+        }
+    }
+
+    void flush() {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (::msync(base_, map_bytes_, MS_SYNC) != 0) fail("msync failed");
+    }
+
+  private:
+    static constexpr std::size_t header_bytes = 64;
+
+    void release() {
+        if (base_) {
+            ::msync(base_, map_bytes_, MS_ASYNC);
+            ::munmap(base_, map_bytes_);
+            base_ = nullptr;
+        }
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+
+    std::size_t slot_bytes() const { return 24 + width_ * sizeof(double); }
+
+    // Four independent mixing chains: one chain is a serial multiply per word, which for a
+    // 32-step record cost more than the lookup it guards.
+    std::uint64_t checksum(const CacheKey& key, const unsigned char* values) const {
+        std::uint64_t c[4] = {splitmix64(key.hi ^ splitmix64(key.lo)), key.hi, key.lo, width_};
+        std::size_t i = 0;
+        for (; i + 4 <= width_; i += 4) {
+            std::uint64_t w[4];
+            std::memcpy(w, values + 8 * i, 32);
+            for (int l = 0; l < 4; ++l) c[l] = cache_mix(c[l], w[l]);
+        }
+        for (; i < width_; ++i) {
+            std::uint64_t w;
+            std::memcpy(&w, values + 8 * i, 8);
+            c[0] = cache_mix(c[0], w);
+        }
+        return splitmix64(cache_mix(cache_mix(cache_mix(c[0], c[1]), c[2]), c[3]));
+    }
+    std::size_t file_bytes(std::uint64_t cap) const { return header_bytes + cap * slot_bytes(); }
+
+    [[noreturn]] void fail(const std::string& what) { throw std::runtime_error("ResultCache: " + what); }
+
+    std::uint32_t header_u32(std::size_t off) const {
+        std::uint32_t v;
+        std::memcpy(&v, base_ + off, 4);
+        return v;
+    }
+    std::uint64_t header_u64(std::size_t off) const {
+        std::uint64_t v;
+        std::memcpy(&v, base_ + off, 8);
+        return v;
+    }
+    void set_header_u64(std::size_t off, std::uint64_t v) { std::memcpy(base_ + off, &v, 8); }
+
+    static bool occupied(const unsigned char* slot) {
+        std::uint64_t k[2];
+        std::memcpy(k, slot, 16);
+        return k[0] != 0 || k[1] != 0;
+    }
+
+    // Slot holding `key`, or the empty slot where it would go (linear probing).
+    unsigned char* find(const CacheKey& key) const { return probe(base_, capacity(), key); }
+
+    unsigned char* probe(unsigned char* base, std::uint64_t cap, const CacheKey& key) const {
+        for (std::uint64_t i = key.hi & (cap - 1);; i = (i + 1) & (cap - 1)) {
+            unsigned char* slot = base + header_bytes + i * slot_bytes();
+            CacheKey k;
+            std::memcpy(&k.hi, slot, 8);
+            std::memcpy(&k.lo, slot + 8, 8);
+            if (k == key || (k.hi == 0 && k.lo == 0)) return slot;
+        }
+    }
+
+    // The table is zero-filled with pwrite rather than sized with ftruncate: a sparse file
+    // allocates its blocks in the page fault of the first store to each page, which cost
+    // about 2 us per insert, more than pricing the grid; writing the zeros up front is one
+    // sequential pass.
+    void create(int fd, std::uint64_t cap) {
+        if (::ftruncate(fd, static_cast<off_t>(file_bytes(cap))) != 0) fail("cannot size " + path_);
+        unsigned char hdr[header_bytes] = {};
+        std::memcpy(hdr, cache_magic, 8);
+        std::memcpy(hdr + 8, &width_, 4);
+        std::memcpy(hdr + 16, &cap, 8);
+        detail::pwrite_all(fd, reinterpret_cast<const char*>(hdr), sizeof(hdr), 0);
+    }
+
+    void map() {
+        struct stat st;
+        if (::fstat(fd_, &st) != 0 || st.st_size < static_cast<off_t>(header_bytes)) fail(path_ + " is truncated");
+        map_bytes_ = static_cast<std::size_t>(st.st_size);
+        void* p = ::mmap(nullptr, map_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) fail("cannot map " + path_);
+        base_ = static_cast<unsigned char*>(p);
+    }
+
+    void grow(std::uint64_t cap) {
+        const std::string tmp = path_ + ".tmp";
+        const int fd = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) fail("cannot open " + tmp);
+        if (::flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            ::close(fd);
+            fail(tmp + " is locked");
+        }
+        create(fd, cap);
+        const std::size_t bytes = file_bytes(cap);
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            fail("cannot map " + tmp);
+        }
+        unsigned char* next = static_cast<unsigned char*>(p);
+        const std::uint64_t old_cap = capacity();
+        for (std::uint64_t i = 0; i < old_cap; ++i) {
+            const unsigned char* slot = base_ + header_bytes + i * slot_bytes();
+            if (!occupied(slot)) continue;
+            CacheKey k;
+            std::memcpy(&k.hi, slot, 8);
+            std::memcpy(&k.lo, slot + 8, 8);
+            std::memcpy(probe(next, cap, k), slot, slot_bytes());
+        }
+        std::memcpy(next + 24, base_ + 24, 8);   // used
+        if (::msync(next, bytes, MS_SYNC) != 0 || ::rename(tmp.c_str(), path_.c_str()) != 0) {
+            ::munmap(next, bytes);
+            ::close(fd);
+            fail("cannot replace " + path_);
+        }
+        ::munmap(base_, map_bytes_);
+        ::close(fd_);
+        fd_ = fd;
+        base_ = next;
+        map_bytes_ = bytes;
+    }
+
+    std::string path_;
+    std::uint32_t width_;
+    int fd_ = -1;
+    unsigned char* base_ = nullptr;
+    std::size_t map_bytes_ = 0;
+    std::atomic<std::uint64_t> hits_{0}, misses_{0};
+    std::shared_mutex mutex_;
+};
+
+// Record layout: `slots` h bit patterns (0 = empty slot), then five values per slot, where
+// slots is max_steps rounded up to a power of two (the step table is probed by mask).
+inline constexpr std::uint32_t h_grid_cache_width(std::size_t max_steps) {
+    std::size_t slots = 1;
+    while (slots < max_steps) slots <<= 1;
+    return static_cast<std::uint32_t>(6 * slots);
+}
+
+namespace detail {
+
+// Slot of h in a record's step table (linear probing from its hash), the empty slot
+// where it would go, or `slots` when h == 0 (uncacheable) or the table is full.
+inline std::size_t h_grid_slot(const double* rec, std::size_t slots, double h) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &h, 8);
+    if (bits == 0) return slots;
+    for (std::size_t j = 0, i = splitmix64(bits) & (slots - 1); j < slots; ++j, i = (i + 1) & (slots - 1)) {
+        std::uint64_t b;
+        std::memcpy(&b, rec + i, 8);
+        if (b == bits || b == 0) return i;
+    }
+    return slots;
+}
+
+} // namespace detail
+
+// compute_greeks_h_grid through the result cache: one record per scenario, keyed on the
+// inputs, holding up to width / 6 steps (per step: FD Δ, Γ, CS Δ, Γ real, Γ 45°). Steps the
+// record lacks are priced in one compute_greeks_h_grid call and added while there is room;
+// per-step results do not depend on the rest of the grid, so a cached step is bit-identical
+// to an uncached one. `steps_computed`, if given, is increased by the steps priced. Without
+// a cache this is compute_greeks_h_grid.
+inline HGridGreeks cached_greeks_h_grid(ResultCache* cache, double S, double K, double r, double q,
+                                        double sigma, double T, const std::vector<double>& h,
+                                        std::size_t* steps_computed = nullptr) {
+    if (!cache) {
+        if (steps_computed) *steps_computed += h.size();
+        return compute_greeks_h_grid(S, K, r, q, sigma, T, h);
+    }
+    const std::size_t n = h.size(), slots = cache->width() / 6;
+    if (cache->width() % 6 != 0 || (slots & (slots - 1)) != 0)
+        throw std::invalid_argument("cached_greeks_h_grid: cache width must be h_grid_cache_width(max_steps)");
+    const double inputs[] = {S, K, r, q, sigma, T};
+    const CacheKey key = cache_key("compute_greeks_h_grid", h_grid_kernel_version, inputs, 6);
+    std::vector<double> rec(cache->width());
+    if (!cache->lookup(key, rec.data())) std::fill(rec.begin(), rec.end(), 0.0);
+    const double* values = rec.data() + slots;
+
+    HGridGreeks out{std::vector<FDGreeks>(n), std::vector<CSGreeks>(n)};
+    std::vector<double> missing;
+    std::vector<std::size_t> where;
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t j = detail::h_grid_slot(rec.data(), slots, h[i]);
+        std::uint64_t bits = 0;
+        if (j < slots) std::memcpy(&bits, &rec[j], 8);
+        if (bits != 0) {
+            const double* v = values + 5 * j;
+            out.fd[i] = {v[0], v[1]};
+            out.cs[i] = {v[2], v[3], v[4]};
+        } else {
+            missing.push_back(h[i]);
+            where.push_back(i);
+        }
+    }
+    if (missing.empty()) return out;
+    if (steps_computed) *steps_computed += missing.size();
+
+    const HGridGreeks fresh = compute_greeks_h_grid(S, K, r, q, sigma, T, missing);
+    bool stored = false;
+    for (std::size_t k = 0; k < missing.size(); ++k) {
+        out.fd[where[k]] = fresh.fd[k];
+        out.cs[where[k]] = fresh.cs[k];
+        const std::size_t j = detail::h_grid_slot(rec.data(), slots, missing[k]);
+        if (j == slots) continue;   // no room: priced on every call
+        double* v = rec.data() + slots + 5 * j;
+        rec[j] = missing[k];
+        v[0] = fresh.fd[k].delta;
+        v[1] = fresh.fd[k].gamma;
+        v[2] = fresh.cs[k].delta;
+        v[3] = fresh.cs[k].gamma_real;
+        v[4] = fresh.cs[k].gamma_45;
+        stored = true;
+    }
+    if (stored) cache->insert(key, rec.data());
+    return out;
+}
+
+} // namespace quant
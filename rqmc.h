@@ -0,0 +1,237 @@
+#pragma once
+/**
+ * @file rqmc.h
+ * @brief Randomized quasi-Monte Carlo: Owen-scrambled Sobol replicates.
+ *
+ * Exposes:
+ *  - SobolSequence:           32-bit Sobol generator (Gray-code order, up to 16 dims).
+ *  - owen_scramble(x, seed):  hash-based nested uniform (Owen) scramble of one coordinate.
+ *  - rqmc_estimate(...):      R independent scrambled replicates run as scheduler tasks,
+ *                             combined into a mean and a standard error.
+ *  - rqmc_estimate_to_tolerance(...): adds replicates in waves until the standard error
+ *                             reaches a target (sequential stopping).
+ *
+ * Normals are produced block-wise through the batch InverseCumulativeNormal operator.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "InverseCumulativeNormal.h"
+#include "task_scheduler.h"
+
+namespace quant {
+
+class SobolSequence {
+  public:
+    static constexpr std::size_t max_dimensions = 16;
+    static constexpr int bits = 32;
+
+    explicit SobolSequence(std::size_t dims) : dims_(dims) {
+        if (dims == 0 || dims > max_dimensions)
+            throw std::invalid_argument("SobolSequence: dims must be in [1, 16]");
+
+        // Joe & Kuo (new-joe-kuo-6.21201) primitive polynomials and initial m_k, dims 2..16.
+        static constexpr unsigned s_[max_dimensions] = {0, 1, 2, 3, 3, 4, 4, 5, 5, 5, 5, 5, 5, 6, 6, 6};
+        static constexpr unsigned a_[max_dimensions] = {0, 0, 1, 1, 2, 1, 4, 2, 4, 7, 11, 13, 14, 1, 13, 16};
+        static constexpr unsigned m_[max_dimensions][6] = {
+            {0, 0, 0, 0, 0, 0},   {1, 0, 0, 0, 0, 0},   {1, 3, 0, 0, 0, 0},    {1, 3, 1, 0, 0, 0},
+            {1, 1, 1, 0, 0, 0},   {1, 1, 3, 3, 0, 0},   {1, 3, 5, 13, 0, 0},   {1, 1, 5, 5, 17, 0},
+            {1, 1, 5, 5, 5, 0},   {1, 1, 7, 11, 19, 0}, {1, 1, 5, 1, 1, 0},    {1, 1, 1, 3, 11, 0},
+            {1, 3, 5, 5, 31, 0},  {1, 3, 3, 9, 7, 49},  {1, 1, 1, 15, 21, 21}, {1, 3, 1, 13, 27, 49}};
+
+        for (std::size_t d = 0; d < dims_; ++d) {
+            std::uint32_t* v = v_[d];
+            if (d == 0) {
+                // First dimension: van der Corput in base 2.
+                for (int k = 0; k < bits; ++k) v[k] = 1u << (bits - 1 - k);
+                continue;
+            }
+            const unsigned s = s_[d];
+            for (unsigned k = 0; k < s; ++k) v[k] = m_[d][k] << (bits - 1 - k);
+            for (int k = static_cast<int>(s); k < bits; ++k) {
+                std::uint32_t vk = v[k - s] ^ (v[k - s] >> s);
+                for (unsigned j = 1; j < s; ++j)
+                    if ((a_[d] >> (s - 1 - j)) & 1u) vk ^= v[k - j];
+                v[k] = vk;
+            }
+        }
+    }
+
+    std::size_t dimensions() const { return dims_; }
+
+    // Restart at the origin (point 0).
+    void reset() {
+        index_ = 0;
+        std::fill(x_, x_ + max_dimensions, 0u);
+    }
+
+    // Writes the current point to out[0..dims) and advances (Gray-code order).
+    inline void next(std::uint32_t* out) {
+        for (std::size_t d = 0; d < dims_; ++d) out[d] = x_[d];
+        const int c = ctz(~index_);
+        for (std::size_t d = 0; d < dims_; ++d) x_[d] ^= v_[d][c];
+        ++index_;
+    }
+
+  private:
+    static inline int ctz(std::uint32_t x) {
+        int c = 0;
+        while ((x & 1u) == 0u && c < bits - 1) { x >>= 1; ++c; }
+        return c;
+    }
+
+    std::size_t dims_;
+    std::uint32_t index_ = 0;
+    std::uint32_t x_[max_dimensions] = {};
+    std::uint32_t v_[max_dimensions][bits] = {};
+};
+
+// ---- Scrambling -------------------------------------------------------------
+
+// SplitMix64 finalizer: decorrelates replicate / dimension seeds.
+inline std::uint64_t splitmix64(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+inline std::uint32_t reverse_bits32(std::uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+    x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+// Nested uniform scramble (Laine–Karras hash on bit-reversed digits, Burley 2020).
+// Each output bit depends only on the same and higher-order input bits, as Owen requires.
+inline std::uint32_t owen_scramble(std::uint32_t x, std::uint32_t seed) {
+    x = reverse_bits32(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return reverse_bits32(x);
+}
+
+// ---- RQMC driver ------------------------------------------------------------
+
+struct RQMCResult {
+    double mean;
+    double std_error;                  // sample std of replicate means / sqrt(R)
+    std::size_t replicates;
+    std::size_t points_per_replicate;
+};
+
+namespace detail {
+
+inline constexpr std::size_t rqmc_block = 256;
+
+// One scrambled replicate: mean of payoff over 2^log2_points points.
+// payoff(const double* z, std::size_t dims) -> double, called with standard normals.
+template <class PathPayoff>
+double rqmc_replicate(std::size_t dims, std::size_t log2_points, std::uint64_t seed,
+                      const PathPayoff& payoff) {
+    SobolSequence sobol(dims);
+    std::uint32_t scramble_seed[SobolSequence::max_dimensions];
+    for (std::size_t d = 0; d < dims; ++d)
+        scramble_seed[d] = static_cast<std::uint32_t>(splitmix64(seed ^ (0x51ed27ull * (d + 1))));
+
+    const InverseCumulativeNormal icn;
+    const std::size_t n = std::size_t(1) << log2_points;
+    std::vector<double> u(rqmc_block * dims), z(rqmc_block * dims);
+    std::uint32_t point[SobolSequence::max_dimensions];
+
+    double sum = 0.0;
+    for (std::size_t start = 0; start < n; start += rqmc_block) {
+        const std::size_t m = std::min(rqmc_block, n - start);
+        for (std::size_t i = 0; i < m; ++i) {
+            sobol.next(point);
+            for (std::size_t d = 0; d < dims; ++d) {
+                const std::uint32_t x = owen_scramble(point[d], scramble_seed[d]);
+                u[i * dims + d] = (static_cast<double>(x) + 0.5) * 0x1p-32;
+            }
+        }
+        icn(u.data(), z.data(), m * dims);
+        for (std::size_t i = 0; i < m; ++i) sum += payoff(z.data() + i * dims, dims);
+    }
+    return sum / static_cast<double>(n);
+}
+
+// Runs replicates [first, first + count) as one task each; results land in est[first + k].
+template <class PathPayoff>
+void rqmc_wave(std::size_t dims, std::size_t log2_points, std::uint64_t seed, const PathPayoff& payoff,
+               std::size_t first, std::size_t count, std::vector<double>& est) {
+    parallel_for(first, first + count, 1, [&](std::size_t lo, std::size_t hi) {
+        for (std::size_t rep = lo; rep < hi; ++rep)
+            est[rep] = rqmc_replicate(dims, log2_points, splitmix64(seed + rep), payoff);
+    });
+}
+
+inline RQMCResult rqmc_combine(const std::vector<double>& est, std::size_t reps, std::size_t log2_points) {
+    double mean = 0.0, m2 = 0.0;
+    for (std::size_t k = 0; k < reps; ++k) {
+        const double delta = est[k] - mean;
+        mean += delta / static_cast<double>(k + 1);
+        m2 += delta * (est[k] - mean);
+    }
+    const double var = reps > 1 ? m2 / static_cast<double>(reps - 1) : 0.0;
+    return {mean, std::sqrt(var / static_cast<double>(reps)), reps, std::size_t(1) << log2_points};
+}
+
+inline unsigned rqmc_threads(unsigned threads) {
+    if (threads == 0) threads = TaskScheduler::global().size();
+    return std::max(1u, threads);
+}
+
+} // namespace detail
+
+// Fixed number of replicates, at most `threads` per wave (0 = scheduler size).
+// Replicate k is seeded from (seed, k) only, so results do not depend on the thread count.
+template <class PathPayoff>
+RQMCResult rqmc_estimate(const PathPayoff& payoff, std::size_t dims, std::size_t log2_points,
+                         std::size_t replicates, std::uint64_t seed = 42, unsigned threads = 0) {
+    if (replicates < 2) throw std::invalid_argument("rqmc_estimate: need at least 2 replicates");
+    const std::size_t wave = detail::rqmc_threads(threads);
+    std::vector<double> est(replicates);
+    for (std::size_t first = 0; first < replicates; first += wave)
+        detail::rqmc_wave(dims, log2_points, seed, payoff, first, std::min(wave, replicates - first), est);
+    return detail::rqmc_combine(est, replicates, log2_points);
+}
+
+// Sequential stopping: run waves of replicates until std_error <= target_se
+// (after at least min_replicates) or max_replicates is reached.
+template <class PathPayoff>
+RQMCResult rqmc_estimate_to_tolerance(const PathPayoff& payoff, std::size_t dims, std::size_t log2_points,
+                                      double target_se, std::size_t min_replicates = 8,
+                                      std::size_t max_replicates = 256, std::uint64_t seed = 42,
+                                      unsigned threads = 0) {
+    min_replicates = std::max<std::size_t>(min_replicates, 2);
+    max_replicates = std::max(max_replicates, min_replicates);
+    const std::size_t wave = detail::rqmc_threads(threads);
+    std::vector<double> est(max_replicates);
+
+    // Replicates are examined in index order, so the stopping point (and the estimate)
+    // is the same for any thread count; surplus replicates of the last wave are dropped.
+    std::size_t done = 0;
+    RQMCResult res{0.0, 0.0, 0, std::size_t(1) << log2_points};
+    while (done < max_replicates) {
+        const std::size_t count = std::min(wave, max_replicates - done);
+        detail::rqmc_wave(dims, log2_points, seed, payoff, done, count, est);
+        for (std::size_t k = done + 1; k <= done + count; ++k) {
+            res = detail::rqmc_combine(est, k, log2_points);
+            if (k >= min_replicates && res.std_error <= target_se) return res;
+        }
+        done += count;
+    }
+    return res;
+}
+
+} // namespace quant
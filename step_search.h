@@ -0,0 +1,198 @@
+#pragma once
+/**
+ * @file step_search.h
+ * @brief Adaptive step-size search for the FD and complex-step Greeks.
+ *
+ * Exposes:
+ *  - GreekMethod:           the five numerical estimators of the validation sweep.
+ *  - StepSearchConfig:      search interval in log10(h_rel), coarse points, tolerance.
+ *  - find_optimal_steps(...): a 7-point, 2-decade coarse pass (one h-grid kernel call,
+ *                           shared by all methods) brackets each method's minimum; Brent's
+ *                           method in log10(h), log10(error) refines it to the tolerance.
+ *
+ * Error = |numerical - analytic|. Above the optimum the error is truncation, smooth and
+ * falling with h; below it, roundoff noise that can dip anywhere. The bracket is found
+ * from the large-h end: the coarse points are walked down while the error keeps falling
+ * by at least a quarter decade per decade, and the last such point and its neighbours
+ * bracket the minimum. A lucky roundoff dip further down is never chosen as a bracket.
+ * Every probe is a candidate. Methods whose error reaches 0 are not refined.
+ *
+ * Evaluations are counted per method and per step, coarse points included, the way a
+ * fixed grid of N steps counts N per method.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include "bs_greeks.h"
+
+enum class GreekMethod { DeltaFD, DeltaCS, GammaFD, GammaCSReal, GammaCS45 };
+
+inline const char* greek_method_name(GreekMethod m) {
+    switch (m) {
+    case GreekMethod::DeltaFD:     return "Delta_fd";
+    case GreekMethod::DeltaCS:     return "Delta_cs";
+    case GreekMethod::GammaFD:     return "Gamma_fd";
+    case GreekMethod::GammaCSReal: return "Gamma_cs_real";
+    case GreekMethod::GammaCS45:   return "Gamma_cs_45";
+    }
+    return "";
+}
+
+struct StepSearchConfig {
+    double log_h_rel_lo = -16.0;
+    double log_h_rel_hi = -4.0;
+    int coarse_points   = 7;      // includes both ends
+    double tol          = 0.1;    // bracket width in decades at which to stop
+    int max_probes      = 12;     // refinement cap per method
+};
+
+struct StepOptimum {
+    GreekMethod method;
+    double h_rel;
+    double error;
+    int evaluations;   // step evaluations for this method, coarse points included
+};
+
+namespace detail {
+
+// |estimate - analytic| of one method at one step size. Prices only the lanes the method
+// reads (C(S) is passed in); the numbers are those of compute_fd_greeks / compute_cs_greeks.
+inline double step_error(GreekMethod m, double S, double K, double r, double q, double sigma, double T,
+                         double C_S, double h, const AnalyticGreeks& a) {
+    switch (m) {
+    case GreekMethod::DeltaFD:
+        return std::abs((bs_price_call(S + h, K, r, q, sigma, T) - C_S) / h - a.delta);
+    case GreekMethod::GammaFD: {
+        const double bumps[2] = {h, 2.0 * h};
+        double C[2];
+        quant::bs_price_call_bumped({S, K, r, q, sigma, T}, quant::BumpAxis::Spot, bumps, C, 2);
+        return std::abs((C[1] - 2.0 * C[0] + C_S) / (h * h) - a.gamma);
+    }
+    case GreekMethod::DeltaCS:
+    case GreekMethod::GammaCSReal: {
+        const std::complex<double> spot(S, h);
+        std::complex<double> C;
+        bs_price_call_cs_spots(&spot, K, r, q, sigma, T, &C, 1, m == GreekMethod::GammaCSReal ? 1 : 0);
+        return m == GreekMethod::DeltaCS ? std::abs(C.imag() / h - a.delta)
+                                         : std::abs(-2.0 * (C.real() - C_S) / (h * h) - a.gamma);
+    }
+    case GreekMethod::GammaCS45: {
+        const double sqrt2 = std::sqrt(2.0);
+        const std::complex<double> omega(1.0/sqrt2, 1.0/sqrt2);
+        const std::complex<double> spots[2] = {S + h * omega, S - h * omega};
+        std::complex<double> C[2];
+        bs_price_call_cs_spots(spots, K, r, q, sigma, T, C, 2, 0);
+        return std::abs((C[0] + C[1]).imag() / (h * h) - a.gamma);
+    }
+    }
+    return 0.0;
+}
+
+inline double grid_error(GreekMethod m, const HGridGreeks& g, std::size_t i, const AnalyticGreeks& a) {
+    switch (m) {
+    case GreekMethod::DeltaFD:     return std::abs(g.fd[i].delta - a.delta);
+    case GreekMethod::GammaFD:     return std::abs(g.fd[i].gamma - a.gamma);
+    case GreekMethod::DeltaCS:     return std::abs(g.cs[i].delta - a.delta);
+    case GreekMethod::GammaCSReal: return std::abs(g.cs[i].gamma_real - a.gamma);
+    case GreekMethod::GammaCS45:   return std::abs(g.cs[i].gamma_45 - a.gamma);
+    }
+    return 0.0;
+}
+
+// Index of the smallest coarse step still on the truncation side: walking down from the
+// largest h, the error must fall by at least a quarter decade per decade of h. Truncation
+// falls at order >= 1; roundoff rises, so noise would need a 10^(step/4)-fold dip to pass.
+inline int truncation_edge(const std::vector<double>& x, const std::vector<double>& e) {
+    int t = static_cast<int>(e.size()) - 1;
+    while (t > 0 && e[t] > 0.0 && e[t - 1] <= e[t] * std::pow(10.0, -0.25 * (x[t] - x[t - 1]))) --t;
+    return t;
+}
+
+} // namespace detail
+
+inline std::vector<StepOptimum> find_optimal_steps(double S, double K, double r, double q, double sigma, double T,
+                                                   const StepSearchConfig& cfg = {}) {
+    static constexpr GreekMethod methods[] = {GreekMethod::DeltaFD, GreekMethod::DeltaCS, GreekMethod::GammaFD,
+                                              GreekMethod::GammaCSReal, GreekMethod::GammaCS45};
+    const AnalyticGreeks a = compute_analytic_greeks(S, K, r, q, sigma, T);
+    const double C_S = bs_price_call(S, K, r, q, sigma, T);
+
+    // Coarse pass: all methods from one h-grid kernel call
+    const int n = std::max(cfg.coarse_points, 3);
+    const double step = (cfg.log_h_rel_hi - cfg.log_h_rel_lo) / (n - 1);
+    std::vector<double> x(n), h(n), e(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = cfg.log_h_rel_lo + i * step;
+        h[i] = std::pow(10.0, x[i]) * S;
+    }
+    const HGridGreeks coarse = compute_greeks_h_grid(S, K, r, q, sigma, T, h);
+
+    std::vector<StepOptimum> out;
+    for (GreekMethod m : methods) {
+        for (int i = 0; i < n; ++i) e[i] = detail::grid_error(m, coarse, i, a);
+        const int t = detail::truncation_edge(x, e);
+        int evals = n;
+        double best_x = x[t], best_err = e[t];
+        if (best_err == 0.0) {
+            out.push_back({m, std::pow(10.0, best_x), best_err, evals});
+            continue;
+        }
+
+        // Brent's method on log10(error) over [x_{t-1}, x_{t+1}], started from the coarse
+        // point x_t. Near the optimum the log-log curve is smooth (a sum of two power laws),
+        // so parabolic steps usually converge in a few probes; golden steps cover the noise.
+        bool exact = false;
+        auto f = [&](double xx) {
+            ++evals;
+            const double err = detail::step_error(m, S, K, r, q, sigma, T, C_S, std::pow(10.0, xx) * S, a);
+            if (err < best_err) { best_err = err; best_x = xx; }
+            exact = err == 0.0;
+            return std::log10(std::max(err, 1e-300));
+        };
+        const double cgold = 0.5 * (3.0 - std::sqrt(5.0));
+        const double tol1 = 0.25 * cfg.tol, tol2 = 2.0 * tol1;
+        double lo = x[std::max(t - 1, 0)], hi = x[std::min(t + 1, n - 1)];
+        double xb = x[t], w = xb, v = xb;
+        double fx = std::log10(e[t]), fw = fx, fv = fx;
+        double d = 0.0, span = 0.0;
+        for (int probe = 0; probe < cfg.max_probes && !exact; ++probe) {
+            const double xm = 0.5 * (lo + hi);
+            if (std::abs(xb - xm) <= tol2 - 0.5 * (hi - lo)) break;
+            bool golden = true;
+            if (std::abs(span) > tol1) {
+                const double rr = (xb - w) * (fx - fv), qq0 = (xb - v) * (fx - fw);
+                double p = (xb - v) * qq0 - (xb - w) * rr, qq = 2.0 * (qq0 - rr);
+                if (qq > 0.0) p = -p;
+                qq = std::abs(qq);
+                const double prev = span;
+                span = d;
+                if (std::abs(p) < std::abs(0.5 * qq * prev) && p > qq * (lo - xb) && p < qq * (hi - xb)) {
+                    d = p / qq;
+                    const double u = xb + d;
+                    if (u - lo < tol2 || hi - u < tol2) d = std::copysign(tol1, xm - xb);
+                    golden = false;
+                }
+            }
+            if (golden) {
+                span = xb >= xm ? lo - xb : hi - xb;
+                d = cgold * span;
+            }
+            const double u = std::abs(d) >= tol1 ? xb + d : xb + std::copysign(tol1, d);
+            const double fu = f(u);
+            if (fu <= fx) {
+                (u >= xb ? lo : hi) = xb;
+                v = w; fv = fw; w = xb; fw = fx; xb = u; fx = fu;
+            } else {
+                (u < xb ? lo : hi) = u;
+                if (fu <= fw || w == xb)               { v = w; fv = fw; w = u; fw = fu; }
+                else if (fu <= fv || v == xb || v == w) { v = u; fv = fu; }
+            }
+        }
+        out.push_back({m, std::pow(10.0, best_x), best_err, evals});
+    }
+    return out;
+}
@@ -0,0 +1,453 @@
+#pragma once
+/**
+ * @file stream_pipeline.h
+ * @brief C++20 coroutine pipeline: mmap reader → batch pricer → writer over bounded channels.
+ *
+ * Exposes:
+ *  - Pipeline:             owns the stage coroutines; every resumption is a task on the
+ *                          shared TaskScheduler, so stages on different threads overlap.
+ *                          run() returns when all stages finish and rethrows the first
+ *                          stage exception (a failing stage closes every channel first).
+ *  - PipelineTask:         coroutine type of a stage (lazily started by Pipeline::run).
+ *  - Channel<T>:           bounded MPMC channel; co_await push(v) suspends while full and
+ *                          yields false once closed, co_await pop() suspends while empty and
+ *                          yields nullopt once closed and drained.
+ *  - write_lines(in, sink): generic text sink stage (std::ostream or AsyncFileWriter).
+ *  - OptionBatch, StreamConfig, StreamStats, price_file(in, out, cfg):
+ *                          file-to-file job. Input: packed little-endian records of six
+ *                          doubles (S, K, r, q, σ, T). Output: price (Kernel::Price) or
+ *                          price, delta, vega (Kernel::Greeks) per option, as raw doubles
+ *                          or CSV, through an AsyncFileWriter (cfg.writer).
+ *
+ * Backpressure comes from a free list of cfg.depth pre-allocated batches circulating
+ * reader → pricer → writer → reader: the working set is depth × batch options whatever
+ * the file size, and consumed input pages are released with MADV_DONTNEED. The pricer
+ * splits each batch with parallel_for, so it also uses idle workers.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "async_writer.h"
+#include "bs_adjoint.h"
+#include "bs_batch.h"
+#include "huge_page_alloc.h"
+#include "task_scheduler.h"
+
+namespace quant {
+
+class Pipeline;
+
+class PipelineTask {
+  public:
+    struct promise_type {
+        Pipeline* pipeline = nullptr;
+
+        PipelineTask get_return_object() {
+            return PipelineTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> h) noexcept;
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception();
+    };
+
+    PipelineTask(PipelineTask&& o) noexcept : h_(std::exchange(o.h_, {})) {}
+    PipelineTask(const PipelineTask&) = delete;
+    ~PipelineTask() { if (h_) h_.destroy(); }
+
+  private:
+    friend class Pipeline;
+    explicit PipelineTask(std::coroutine_handle<promise_type> h) : h_(h) {}
+    std::coroutine_handle<promise_type> h_;
+};
+
+class Pipeline {
+  public:
+    explicit Pipeline(TaskScheduler& s = TaskScheduler::global()) : scheduler_(s) {}
+    ~Pipeline() {
+        for (auto h : stages_) h.destroy();
+    }
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    void spawn(PipelineTask t) {
+        t.h_.promise().pipeline = this;
+        stages_.push_back(std::exchange(t.h_, {}));
+    }
+
+    void run() {
+        live_.store(stages_.size(), std::memory_order_relaxed);
+        {
+            TaskGroup group(scheduler_);
+            group_ = &group;
+            for (auto h : stages_) schedule(h);
+            group.wait();
+            group_ = nullptr;
+        }
+        if (error_) std::rethrow_exception(error_);
+        if (live_.load(std::memory_order_acquire) != 0)
+            throw std::logic_error("Pipeline::run: stages blocked forever (unclosed channel?)");
+    }
+
+    // Internal: channel wake-ups and stage completion.
+    void schedule(std::coroutine_handle<> h) { group_->run([h] { h.resume(); }); }
+
+    void on_close(std::function<void()> closer) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        closers_.push_back(std::move(closer));
+    }
+
+    void fail(std::exception_ptr e) {
+        std::vector<std::function<void()>> closers;
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            if (!error_) error_ = e;
+            closers = closers_;
+        }
+        for (auto& c : closers) c();
+    }
+
+    void finished() { live_.fetch_sub(1, std::memory_order_acq_rel); }
+
+  private:
+    TaskScheduler& scheduler_;
+    TaskGroup* group_ = nullptr;
+    std::vector<std::coroutine_handle<PipelineTask::promise_type>> stages_;
+    std::atomic<std::size_t> live_{0};
+    std::mutex mutex_;
+    std::vector<std::function<void()>> closers_;
+    std::exception_ptr error_;
+};
+
+inline void PipelineTask::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+    h.promise().pipeline->finished();
+}
+
+inline void PipelineTask::promise_type::unhandled_exception() { pipeline->fail(std::current_exception()); }
+
+template <class T>
+class Channel {
+  public:
+    Channel(Pipeline& p, std::size_t capacity) : pipeline_(p), capacity_(capacity) {
+        p.on_close([this] { close(); });
+    }
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    struct PushAwaiter {
+        Channel& c;
+        T value;
+        bool ok = true;
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::unique_lock<std::mutex> lk(c.mutex_);
+            if (c.closed_) { ok = false; return false; }
+            if (!c.poppers_.empty()) {                       // hand straight to a waiting consumer
+                const PopWaiter w = c.poppers_.front();
+                c.poppers_.pop_front();
+                *w.slot = std::move(value);
+                lk.unlock();
+                c.pipeline_.schedule(w.h);
+                return false;
+            }
+            if (c.buffer_.size() < c.capacity_) { c.buffer_.push_back(std::move(value)); return false; }
+            c.pushers_.push_back({h, &value, &ok});
+            return true;                                     // `this` may be resumed from here on
+        }
+        bool await_resume() const noexcept { return ok; }
+    };
+
+    struct PopAwaiter {
+        Channel& c;
+        std::optional<T> slot;
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::unique_lock<std::mutex> lk(c.mutex_);
+            std::coroutine_handle<> wake;
+            if (!c.buffer_.empty()) {
+                slot = std::move(c.buffer_.front());
+                c.buffer_.pop_front();
+                if (!c.pushers_.empty()) {                   // room now: admit one blocked producer
+                    const PushWaiter w = c.pushers_.front();
+                    c.pushers_.pop_front();
+                    c.buffer_.push_back(std::move(*w.value));
+                    wake = w.h;
+                }
+            } else if (!c.pushers_.empty()) {                // capacity 0: rendezvous
+                const PushWaiter w = c.pushers_.front();
+                c.pushers_.pop_front();
+                slot = std::move(*w.value);
+                wake = w.h;
+            } else if (!c.closed_) {
+                c.poppers_.push_back({h, &slot});
+                return true;
+            }
+            lk.unlock();
+            if (wake) c.pipeline_.schedule(wake);
+            return false;
+        }
+        std::optional<T> await_resume() { return std::move(slot); }
+    };
+
+    PushAwaiter push(T v) { return {*this, std::move(v)}; }
+    PopAwaiter pop() { return {*this, std::nullopt}; }
+
+    // Non-suspending push for seeding a channel before the pipeline runs; false if full or closed.
+    bool try_push(T v) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        if (closed_ || buffer_.size() >= capacity_ || !poppers_.empty()) return false;
+        buffer_.push_back(std::move(v));
+        return true;
+    }
+
+    // Consumers drain what is buffered, then get nullopt; blocked producers get false.
+    void close() {
+        std::deque<PopWaiter> poppers;
+        std::deque<PushWaiter> pushers;
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            if (closed_) return;
+            closed_ = true;
+            poppers.swap(poppers_);
+            pushers.swap(pushers_);
+            for (const PushWaiter& w : pushers) *w.ok = false;
+        }
+        for (const PopWaiter& w : poppers) pipeline_.schedule(w.h);
+        for (const PushWaiter& w : pushers) pipeline_.schedule(w.h);
+    }
+
+  private:
+    struct PushWaiter {
+        std::coroutine_handle<> h;
+        T* value;
+        bool* ok;
+    };
+    struct PopWaiter {
+        std::coroutine_handle<> h;
+        std::optional<T>* slot;
+    };
+
+    Pipeline& pipeline_;
+    const std::size_t capacity_;
+    std::mutex mutex_;
+    std::deque<T> buffer_;
+    std::deque<PushWaiter> pushers_;
+    std::deque<PopWaiter> poppers_;
+    bool closed_ = false;
+};
+
+// Text sink: every line popped from `in` is written to `os` in order.
+inline PipelineTask write_lines(Channel<std::string>& in, std::ostream& os) {
+    while (std::optional<std::string> line = co_await in.pop()) os << *line;
+}
+
+inline PipelineTask write_lines(Channel<std::string>& in, AsyncFileWriter& out) {
+    while (std::optional<std::string> line = co_await in.pop()) out.write(line->data(), line->size());
+}
+
+// File-to-file pricing
+
+struct OptionBatch {
+    std::size_t first = 0, n = 0;
+    huge_vector<double> S, K, r, q, sigma, T;
+    huge_vector<double> price, delta, vega, dK, dr, dq, dT;
+
+    explicit OptionBatch(std::size_t capacity) {
+        for (huge_vector<double>* v : {&S, &K, &r, &q, &sigma, &T, &price, &delta, &vega, &dK, &dr, &dq, &dT})
+            v->resize(capacity);
+    }
+};
+
+struct StreamConfig {
+    enum class Kernel { Price, Greeks };
+    enum class Format { Binary, CSV };
+
+    std::size_t batch = std::size_t(1) << 16;   // options per batch
+    std::size_t depth = 4;                      // batches in circulation (memory bound)
+    std::size_t grain = 4096;                   // pricer parallel_for grain
+    Kernel kernel = Kernel::Price;
+    Format format = Format::Binary;
+    AsyncWriterConfig writer;                   // output buffers, io_uring, O_DIRECT
+};
+
+struct StreamStats {
+    std::size_t options = 0;
+    std::size_t batches = 0;
+};
+
+inline constexpr std::size_t option_record_doubles = 6;
+
+namespace detail {
+
+class MappedFile {
+  public:
+    explicit MappedFile(const std::string& path) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) throw std::runtime_error("price_file: cannot open " + path);
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0) { ::close(fd_); throw std::runtime_error("price_file: cannot stat " + path); }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (p == MAP_FAILED) { ::close(fd_); throw std::runtime_error("price_file: cannot map " + path); }
+            data_ = static_cast<const unsigned char*>(p);
+            ::madvise(p, size_, MADV_SEQUENTIAL);
+        }
+    }
+    ~MappedFile() {
+        if (data_) ::munmap(const_cast<unsigned char*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+    // Drop whole pages of [0, end) from the working set once they have been consumed.
+    void release_before(std::size_t end) {
+        const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t upto = end / page * page;
+        if (upto > released_) {
+            ::madvise(const_cast<unsigned char*>(data_) + released_, upto - released_, MADV_DONTNEED);
+            released_ = upto;
+        }
+    }
+
+  private:
+    int fd_ = -1;
+    const unsigned char* data_ = nullptr;
+    std::size_t size_ = 0, released_ = 0;
+};
+
+inline PipelineTask read_options(MappedFile& file, std::size_t batch, Channel<OptionBatch*>& free,
+                                 Channel<OptionBatch*>& out) {
+    const std::size_t record = option_record_doubles * sizeof(double);
+    const std::size_t n = file.size() / record;
+    for (std::size_t first = 0; first < n; first += batch) {
+        std::optional<OptionBatch*> b = co_await free.pop();
+        if (!b) break;
+        OptionBatch& B = **b;
+        B.first = first;
+        B.n = std::min(batch, n - first);
+        const unsigned char* src = file.data() + first * record;
+        for (std::size_t i = 0; i < B.n; ++i) {             // AoS records → SoA lanes
+            double rec[option_record_doubles];
+            std::memcpy(rec, src + i * record, record);
+            B.S[i] = rec[0]; B.K[i] = rec[1]; B.r[i] = rec[2];
+            B.q[i] = rec[3]; B.sigma[i] = rec[4]; B.T[i] = rec[5];
+        }
+        file.release_before((first + B.n) * record);
+        if (!co_await out.push(*b)) break;
+    }
+    out.close();
+}
+
+inline PipelineTask price_batches(StreamConfig cfg, Channel<OptionBatch*>& in, Channel<OptionBatch*>& out) {
+    while (std::optional<OptionBatch*> b = co_await in.pop()) {
+        OptionBatch& B = **b;
+        parallel_for(0, B.n, cfg.grain, [&](std::size_t lo, std::size_t hi) {
+            if (cfg.kernel == StreamConfig::Kernel::Price)
+                bs_price_call_batch(&B.S[lo], &B.K[lo], &B.r[lo], &B.q[lo], &B.sigma[lo], &B.T[lo], &B.price[lo],
+                                    hi - lo);
+            else
+                bs_price_call_adjoint_batch(&B.S[lo], &B.K[lo], &B.r[lo], &B.q[lo], &B.sigma[lo], &B.T[lo],
+                                            &B.price[lo], &B.delta[lo], &B.dK[lo], &B.dr[lo], &B.dq[lo],
+                                            &B.vega[lo], &B.dT[lo], hi - lo);
+        });
+        if (!co_await out.push(*b)) break;
+    }
+    out.close();
+}
+
+inline PipelineTask write_batches(StreamConfig cfg, AsyncFileWriter& out, Channel<OptionBatch*>& in,
+                                  Channel<OptionBatch*>& free, StreamStats& stats) {
+    const bool greeks = cfg.kernel == StreamConfig::Kernel::Greeks;
+    std::vector<char> buf;
+    while (std::optional<OptionBatch*> b = co_await in.pop()) {
+        const OptionBatch& B = **b;
+        buf.clear();
+        if (cfg.format == StreamConfig::Format::Binary) {
+            const std::size_t width = greeks ? 3 : 1;
+            buf.resize(B.n * width * sizeof(double));
+            double* o = reinterpret_cast<double*>(buf.data());
+            for (std::size_t i = 0; i < B.n; ++i) {
+                o[i * width] = B.price[i];
+                if (greeks) { o[i * width + 1] = B.delta[i]; o[i * width + 2] = B.vega[i]; }
+            }
+        } else {
+            char line[96];
+            for (std::size_t i = 0; i < B.n; ++i) {
+                const int len = greeks
+                    ? std::snprintf(line, sizeof(line), "%.16e,%.16e,%.16e\n", B.price[i], B.delta[i], B.vega[i])
+                    : std::snprintf(line, sizeof(line), "%.16e\n", B.price[i]);
+                buf.insert(buf.end(), line, line + len);
+            }
+        }
+        out.write(buf.data(), buf.size());
+        stats.options += B.n;
+        ++stats.batches;
+        if (!co_await free.push(*b)) break;
+    }
+}
+
+} // namespace detail
+
+// Prices every record of `input` into `output` (created or truncated). CSV output starts
+// with a header line. Throws std::runtime_error on I/O failure.
+inline StreamStats price_file(const std::string& input, const std::string& output, const StreamConfig& cfg = {},
+                              TaskScheduler& s = TaskScheduler::global()) {
+    detail::MappedFile file(input);
+    AsyncFileWriter out(output, cfg.writer);
+    if (cfg.format == StreamConfig::Format::CSV) {
+        const char* header = cfg.kernel == StreamConfig::Kernel::Greeks ? "price,delta,vega\n" : "price\n";
+        out.write(header, std::strlen(header));
+    }
+
+    const std::size_t depth = std::max<std::size_t>(cfg.depth, 2);
+    const std::size_t batch = std::max<std::size_t>(cfg.batch, 1);
+    std::vector<std::unique_ptr<OptionBatch>> pool;
+    Pipeline p(s);
+    Channel<OptionBatch*> free(p, depth), loaded(p, depth), priced(p, depth);
+    for (std::size_t k = 0; k < depth; ++k) {
+        pool.emplace_back(new OptionBatch(batch));
+        free.try_push(pool.back().get());
+    }
+    StreamStats stats;
+    p.spawn(detail::read_options(file, batch, free, loaded));
+    p.spawn(detail::price_batches(cfg, loaded, priced));
+    p.spawn(detail::write_batches(cfg, out, priced, free, stats));
+    p.run();
+    out.close();
+    return stats;
+}
+
+} // namespace quant
@@ -0,0 +1,429 @@
+#pragma once
+/**
+ * @file sweep_engine.h
+ * @brief Block-parallel scenario sweep with atomic checkpoints and exact resume.
+ *
+ * Exposes:
+ *  - SweepConfig, SweepResult:   block size, checkpoint file and interval, seed, cancel token.
+ *  - run_sweep(out, n, width, eval, cfg): eval(i, seed_i, record) fills `width` doubles for
+ *                                scenario i; records are appended to `out` in scenario order
+ *                                and every column gets WelfordStats over the committed range.
+ *  - SweepStatNode, SweepCheckpoint, read_checkpoint / write_checkpoint: the on-disk resume
+ *                                state.
+ *  - sweep_shard_range(total, block, shard, shards): the block-aligned scenario range of
+ *                                one shard (cfg.shard / cfg.shards select it in run_sweep).
+ *  - merge_sweep_shards(shards, out, out_checkpoint): concatenates complete shard outputs
+ *                                and combines their statistics into one sweep.
+ *  - fnv1a64(bytes):             fingerprint helper for sweep definitions.
+ *
+ * Scenarios run in blocks of cfg.block (parallel_for inside a block); a block is committed
+ * when all of it is done. Scenario i is seeded from splitmix64(seed + i) alone, so the RNG
+ * state of the whole sweep is (seed, completed range) and nothing else needs saving.
+ *
+ * Column statistics are kept on a fixed tree over global block indices: node (level j,
+ * index k) covers blocks [k·2^j, (k+1)·2^j) and is always formed by merging its two
+ * children. A run holds only the maximal complete nodes of its committed range, at most
+ * about 2·log2(blocks) of them, pushing each block as a leaf and merging siblings as they
+ * complete; totals fold those nodes left to right. A checkpoint therefore stays a few KB
+ * however long the sweep, instead of growing by one entry per block.
+ *
+ * A checkpoint holds the completed range, those tree nodes and the sweep's identity
+ * (seed, width, block, fingerprint). It is written at most every
+ * cfg.checkpoint_seconds, on cancellation and at the end: output fdatasync'd first, then
+ * checkpoint to "<path>.tmp", fsync, rename, fsync of the directory. A crash therefore
+ * leaves either the old or the new checkpoint, never one pointing past durable records.
+ *
+ * Resuming truncates the output to the checkpoint's range and continues from the next
+ * block. Every node value depends only on its blocks, so an interrupted and resumed sweep
+ * produces the same bytes and the same statistics as an uninterrupted one.
+ *
+ * Shards are independent processes (sharing nothing but a filesystem) that each run one
+ * block-aligned slice of the same sweep. Their blocks are exactly the blocks of the
+ * single-process run and their nodes are nodes of the same tree, so the merge, pushing
+ * the shards' nodes in order, reproduces its output file, checkpoint and statistics
+ * bit for bit.
+ *
+ * Output layout (little-endian): "QSWP0001" | u64 total | u64 first | u64 count |
+ * u32 width | u32 0 | records (count × width doubles, scenarios [first, first + count)).
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "async_writer.h"
+#include "columnar_codec.h"
+#include "mc_engine.h"
+#include "rqmc.h"
+#include "task_scheduler.h"
+
+namespace quant {
+
+struct SweepConfig {
+    std::size_t block = 1024;                  // scenarios per commit / statistics block
+    std::size_t grain = 8;                     // parallel_for grain inside a block
+    std::string checkpoint;                    // empty: no checkpoints, no resume
+    double checkpoint_seconds = 30.0;          // minimum wall time between checkpoints
+    std::uint64_t seed = 42;
+    std::uint64_t fingerprint = 0;             // identifies the sweep definition (fnv1a64)
+    const std::atomic<bool>* cancel = nullptr; // stop after the current block, checkpointed
+    unsigned shard = 0, shards = 1;            // run only slice `shard` of `shards`
+};
+
+struct SweepResult {
+    std::size_t first = 0, count = 0;          // this run's scenario range (the shard)
+    std::size_t done = 0;                      // scenarios committed (a prefix of the range)
+    std::size_t resumed_from = 0;              // scenarios already done at start
+    std::size_t checkpoints = 0;               // checkpoints written by this call
+    bool complete = false;
+    std::vector<WelfordStats> stats;           // per column, over the committed prefix
+};
+
+inline std::uint64_t fnv1a64(std::string_view bytes, std::uint64_t h = 0xcbf29ce484222325ull) {
+    for (unsigned char c : bytes) h = (h ^ c) * 0x100000001b3ull;
+    return h;
+}
+
+inline constexpr char sweep_magic[8] = {'Q', 'S', 'W', 'P', '0', '0', '0', '1'};
+inline constexpr char checkpoint_magic[8] = {'Q', 'C', 'K', 'P', '0', '0', '0', '2'};
+inline constexpr std::size_t sweep_header_bytes = 40;
+
+struct SweepRange {
+    std::size_t first = 0, count = 0;
+};
+
+// Whole blocks are dealt out as evenly as possible; shard i gets blocks [i·nb/N, (i+1)·nb/N).
+inline SweepRange sweep_shard_range(std::size_t total, std::size_t block, unsigned shard, unsigned shards) {
+    if (shards == 0 || shard >= shards) throw std::invalid_argument("sweep_shard_range: shard out of range");
+    block = std::max<std::size_t>(block, 1);
+    const std::size_t nb = (total + block - 1) / block;
+    const std::size_t b0 = nb * shard / shards, b1 = nb * (shard + 1) / shards;
+    const std::size_t first = std::min(total, b0 * block);
+    return {first, std::min(total, b1 * block) - first};
+}
+
+// Column statistics of blocks [index·2^level, (index+1)·2^level).
+struct SweepStatNode {
+    std::uint32_t level = 0;
+    std::uint64_t index = 0;
+    std::vector<WelfordStats> columns;
+};
+
+struct SweepCheckpoint {
+    std::uint64_t fingerprint = 0, seed = 0;
+    std::uint64_t total = 0;                   // scenarios in the whole sweep
+    std::uint64_t first = 0, count = 0;        // range of this run (a shard, or everything)
+    std::uint32_t width = 0, block = 0;
+    std::uint64_t done = 0;                    // [first, first + done) is committed
+    std::vector<SweepStatNode> nodes;          // maximal complete tree nodes, left to right
+
+    bool same_sweep(const SweepCheckpoint& o) const {
+        return fingerprint == o.fingerprint && seed == o.seed && total == o.total && first == o.first
+            && count == o.count && width == o.width && block == o.block;
+    }
+
+    // Appends the node just right of the last one and merges completed sibling pairs.
+    void push(SweepStatNode node) {
+        nodes.push_back(std::move(node));
+        while (nodes.size() >= 2) {
+            SweepStatNode& l = nodes[nodes.size() - 2];
+            const SweepStatNode& r = nodes.back();
+            if (l.level != r.level || l.index % 2 != 0 || r.index != l.index + 1) break;
+            for (std::size_t c = 0; c < l.columns.size(); ++c) l.columns[c].merge(r.columns[c]);
+            ++l.level;
+            l.index /= 2;
+            nodes.pop_back();
+        }
+    }
+
+    std::vector<WelfordStats> totals() const {
+        std::vector<WelfordStats> t(width);
+        for (const SweepStatNode& node : nodes)
+            for (std::size_t c = 0; c < width; ++c) t[c].merge(node.columns[c]);
+        return t;
+    }
+};
+
+namespace detail {
+
+// fdatasync where it exists (Linux); fsync elsewhere, which also flushes metadata.
+inline int sync_data(int fd) {
+#ifdef __linux__
+    return ::fdatasync(fd);
+#else
+    return ::fsync(fd);
+#endif
+}
+
+inline void fsync_or_throw(int fd, const std::string& what) {
+    if (::fsync(fd) != 0) throw std::runtime_error(what + ": fsync failed: " + std::strerror(errno));
+}
+
+inline void put_f64(std::vector<std::uint8_t>& out, double x) { put_le<std::uint64_t>(out, double_bits(x)); }
+inline double get_f64(const std::uint8_t* p) { return bits_double(get_le<std::uint64_t>(p)); }
+
+inline std::vector<std::uint8_t> sweep_header(const SweepCheckpoint& ck) {
+    std::vector<std::uint8_t> hdr(sweep_magic, sweep_magic + 8);
+    put_le(hdr, ck.total);
+    put_le(hdr, ck.first);
+    put_le(hdr, ck.count);
+    put_le(hdr, ck.width);
+    put_le<std::uint32_t>(hdr, 0);
+    return hdr;
+}
+
+} // namespace detail
+
+inline void write_checkpoint(const std::string& path, const SweepCheckpoint& ck) {
+    std::vector<std::uint8_t> buf(checkpoint_magic, checkpoint_magic + 8);
+    detail::put_le(buf, ck.fingerprint);
+    detail::put_le(buf, ck.seed);
+    detail::put_le(buf, ck.total);
+    detail::put_le(buf, ck.first);
+    detail::put_le(buf, ck.count);
+    detail::put_le(buf, ck.width);
+    detail::put_le(buf, ck.block);
+    detail::put_le(buf, ck.done);
+    detail::put_le<std::uint64_t>(buf, ck.nodes.size());
+    for (const SweepStatNode& node : ck.nodes) {
+        detail::put_le(buf, node.level);
+        detail::put_le<std::uint32_t>(buf, 0);
+        detail::put_le(buf, node.index);
+        for (const WelfordStats& w : node.columns) {
+            detail::put_f64(buf, w.n);
+            detail::put_f64(buf, w.mean);
+            detail::put_f64(buf, w.m2);
+        }
+    }
+    detail::put_le(buf, fnv1a64({reinterpret_cast<const char*>(buf.data()), buf.size()}));
+
+    const std::string tmp = path + ".tmp";
+    const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) throw std::runtime_error("write_checkpoint: cannot open " + tmp);
+    try {
+        detail::pwrite_all(fd, reinterpret_cast<const char*>(buf.data()), buf.size(), 0);
+        detail::fsync_or_throw(fd, tmp);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    if (::rename(tmp.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("write_checkpoint: rename to " + path + " failed");
+    const std::size_t slash = path.rfind('/');
+    const std::string dir = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+    const int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd >= 0) {
+        ::fsync(dfd);
+        ::close(dfd);
+    }
+}
+
+// False if `path` does not exist; throws if it exists but is damaged.
+inline bool read_checkpoint(const std::string& path, SweepCheckpoint& ck) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    const std::vector<std::uint8_t> buf((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    constexpr std::size_t fixed = 8 + 8 * 5 + 4 * 2 + 8 + 8;
+    if (buf.size() < fixed + 8 || std::memcmp(buf.data(), checkpoint_magic, 8) != 0)
+        throw std::runtime_error("read_checkpoint: " + path + " is not a sweep checkpoint");
+    const std::uint8_t* p = buf.data() + 8;
+    ck.fingerprint = detail::get_le<std::uint64_t>(p);  p += 8;
+    ck.seed = detail::get_le<std::uint64_t>(p);         p += 8;
+    ck.total = detail::get_le<std::uint64_t>(p);        p += 8;
+    ck.first = detail::get_le<std::uint64_t>(p);        p += 8;
+    ck.count = detail::get_le<std::uint64_t>(p);        p += 8;
+    ck.width = detail::get_le<std::uint32_t>(p);        p += 4;
+    ck.block = detail::get_le<std::uint32_t>(p);        p += 4;
+    ck.done = detail::get_le<std::uint64_t>(p);         p += 8;
+    const std::uint64_t n = detail::get_le<std::uint64_t>(p);  p += 8;
+    const std::uint64_t node_bytes = 16 + std::uint64_t(ck.width) * 24;
+    if (n > buf.size() / node_bytes || buf.size() != fixed + n * node_bytes + 8
+        || detail::get_le<std::uint64_t>(buf.data() + buf.size() - 8)
+               != fnv1a64({reinterpret_cast<const char*>(buf.data()), buf.size() - 8}))
+        throw std::runtime_error("read_checkpoint: " + path + " is truncated or corrupt");
+    ck.nodes.resize(n);
+    for (SweepStatNode& node : ck.nodes) {
+        node.level = detail::get_le<std::uint32_t>(p);
+        node.index = detail::get_le<std::uint64_t>(p + 8);
+        p += 16;
+        node.columns.resize(ck.width);
+        for (WelfordStats& w : node.columns) {
+            w.n = detail::get_f64(p);
+            w.mean = detail::get_f64(p + 8);
+            w.m2 = detail::get_f64(p + 16);
+            p += 24;
+        }
+    }
+    return true;
+}
+
+template <class Eval>
+SweepResult run_sweep(const std::string& out_path, std::size_t scenarios, std::size_t width, Eval&& eval,
+                      const SweepConfig& cfg = {}, TaskScheduler& s = TaskScheduler::global()) {
+    if (width == 0) throw std::invalid_argument("run_sweep: width must be positive");
+    const std::size_t B = std::max<std::size_t>(cfg.block, 1);
+    const std::size_t row_bytes = width * sizeof(double);
+
+    SweepCheckpoint ck;
+    ck.fingerprint = cfg.fingerprint;
+    ck.seed = cfg.seed;
+    ck.total = scenarios;
+    const SweepRange range = sweep_shard_range(scenarios, B, cfg.shard, cfg.shards);
+    ck.first = range.first;
+    ck.count = range.count;
+    ck.width = static_cast<std::uint32_t>(width);
+    ck.block = static_cast<std::uint32_t>(B);
+
+    SweepCheckpoint saved;
+    const bool resume = !cfg.checkpoint.empty() && read_checkpoint(cfg.checkpoint, saved);
+    if (resume) {
+        if (!saved.same_sweep(ck))
+            throw std::runtime_error("run_sweep: checkpoint " + cfg.checkpoint + " belongs to a different sweep");
+        ck = std::move(saved);
+    }
+
+    const int fd = ::open(out_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) throw std::runtime_error("run_sweep: cannot open " + out_path);
+    struct Closer { int fd; ~Closer() { ::close(fd); } } closer{fd};
+
+    const std::uint64_t committed = sweep_header_bytes + ck.done * row_bytes;
+    if (resume) {
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<std::uint64_t>(st.st_size) < committed)
+            throw std::runtime_error("run_sweep: " + out_path + " is shorter than its checkpoint");
+    }
+    if (::ftruncate(fd, static_cast<off_t>(committed)) != 0)
+        throw std::runtime_error("run_sweep: cannot truncate " + out_path);
+    if (!resume) {
+        const std::vector<std::uint8_t> hdr = detail::sweep_header(ck);
+        detail::pwrite_all(fd, reinterpret_cast<const char*>(hdr.data()), hdr.size(), 0);
+    }
+
+    SweepResult res;
+    res.first = ck.first;
+    res.count = ck.count;
+    res.resumed_from = ck.done;
+    using clock = std::chrono::steady_clock;
+    auto last = clock::now();
+    auto checkpoint = [&] {
+        if (cfg.checkpoint.empty()) return;
+        if (detail::sync_data(fd) != 0) throw std::runtime_error("run_sweep: fdatasync of " + out_path + " failed");
+        write_checkpoint(cfg.checkpoint, ck);
+        ++res.checkpoints;
+        last = clock::now();
+    };
+
+    std::vector<double> rows(B * width);
+    while (ck.done < ck.count) {
+        if (cfg.cancel && cfg.cancel->load(std::memory_order_relaxed)) break;
+        const std::size_t lo = ck.done, n = std::min<std::size_t>(B, ck.count - lo);
+        parallel_for(std::size_t(0), n, cfg.grain, [&](std::size_t a, std::size_t b) {
+            for (std::size_t k = a; k < b; ++k) {
+                const std::uint64_t i = ck.first + lo + k;
+                eval(static_cast<std::size_t>(i), splitmix64(cfg.seed + i), rows.data() + k * width);
+            }
+        }, s);
+        SweepStatNode leaf{0, (ck.first + lo) / B, std::vector<WelfordStats>(width)};
+        for (std::size_t k = 0; k < n; ++k)
+            for (std::size_t c = 0; c < width; ++c) leaf.columns[c].add(rows[k * width + c]);
+        detail::pwrite_all(fd, reinterpret_cast<const char*>(rows.data()), n * row_bytes,
+                           sweep_header_bytes + lo * row_bytes);
+        ck.push(std::move(leaf));
+        ck.done += n;
+        if (std::chrono::duration<double>(clock::now() - last).count() >= cfg.checkpoint_seconds) checkpoint();
+    }
+    checkpoint();
+
+    res.done = ck.done;
+    res.complete = ck.done == ck.count;
+    res.stats = ck.totals();
+    return res;
+}
+
+struct SweepShard {
+    std::string output, checkpoint;
+};
+
+// Every shard must be complete and from the same sweep, and together they must cover it
+// exactly once (in any argument order). Writes the merged output and its checkpoint.
+inline SweepResult merge_sweep_shards(std::vector<SweepShard> shards, const std::string& out_path,
+                                      const std::string& out_checkpoint) {
+    if (shards.empty()) throw std::invalid_argument("merge_sweep_shards: no shards");
+    std::vector<SweepCheckpoint> cks(shards.size());
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        if (!read_checkpoint(shards[i].checkpoint, cks[i]))
+            throw std::runtime_error("merge_sweep_shards: missing checkpoint " + shards[i].checkpoint);
+        if (cks[i].done != cks[i].count)
+            throw std::runtime_error("merge_sweep_shards: shard " + shards[i].output + " is incomplete");
+    }
+    std::vector<std::size_t> order(shards.size());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return cks[a].first < cks[b].first; });
+
+    SweepCheckpoint merged = cks[order[0]];
+    merged.first = 0;
+    merged.count = merged.done = merged.total;
+    merged.nodes.clear();
+    std::uint64_t next = 0;
+    for (std::size_t i : order) {
+        const SweepCheckpoint& c = cks[i];
+        if (c.fingerprint != merged.fingerprint || c.seed != merged.seed || c.total != merged.total
+            || c.width != merged.width || c.block != merged.block)
+            throw std::runtime_error("merge_sweep_shards: " + shards[i].output + " is from a different sweep");
+        if (c.first != next)
+            throw std::runtime_error("merge_sweep_shards: shards leave a gap or overlap at scenario " +
+                                     std::to_string(next));
+        next += c.count;
+        for (const SweepStatNode& node : c.nodes) merged.push(node);
+    }
+    if (next != merged.total) throw std::runtime_error("merge_sweep_shards: shards do not cover the sweep");
+
+    const int fd = ::open(out_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) throw std::runtime_error("merge_sweep_shards: cannot open " + out_path);
+    struct Closer { int fd; ~Closer() { ::close(fd); } } closer{fd};
+    const std::vector<std::uint8_t> hdr = detail::sweep_header(merged);
+    detail::pwrite_all(fd, reinterpret_cast<const char*>(hdr.data()), hdr.size(), 0);
+    std::uint64_t offset = hdr.size();
+    std::vector<char> buf(std::size_t(1) << 20);
+    for (std::size_t i : order) {
+        std::ifstream in(shards[i].output, std::ios::binary);
+        std::vector<char> got(sweep_header_bytes);
+        const std::vector<std::uint8_t> want = detail::sweep_header(cks[i]);
+        if (!in.read(got.data(), got.size()) || std::memcmp(got.data(), want.data(), want.size()) != 0)
+            throw std::runtime_error("merge_sweep_shards: " + shards[i].output + " does not match its checkpoint");
+        std::uint64_t left = cks[i].count * cks[i].width * sizeof(double);
+        while (left > 0) {
+            const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(left, buf.size()));
+            if (!in.read(buf.data(), n))
+                throw std::runtime_error("merge_sweep_shards: " + shards[i].output + " is truncated");
+            detail::pwrite_all(fd, buf.data(), n, offset);
+            offset += n;
+            left -= n;
+        }
+    }
+    if (detail::sync_data(fd) != 0) throw std::runtime_error("merge_sweep_shards: fdatasync of " + out_path + " failed");
+    write_checkpoint(out_checkpoint, merged);
+
+    SweepResult res;
+    res.count = res.done = merged.total;
+    res.complete = true;
+    res.stats = merged.totals();
+    return res;
+}
+
+} // namespace quant
@@ -0,0 +1,147 @@
+#pragma once
+/**
+ * @file task_graph.h
+ * @brief Dependency-driven DAG executor on the shared task scheduler, with per-node timing.
+ *
+ * Exposes:
+ *  - TaskGraph::add(name, fn, deps):  a node that runs fn() once every dep has finished.
+ *                                     Deps must be existing nodes, so graphs are acyclic
+ *                                     and node ids are a topological order.
+ *  - TaskGraph::run(scheduler):       roots are spawned at once; each finishing node
+ *                                     releases the successors whose last input it was.
+ *  - NodeTiming, timings():           start / finish of every node (seconds from run start).
+ *  - critical_path():                 the chain of nodes with the largest summed duration,
+ *                                     i.e. the lower bound on the makespan at any core count.
+ *  - write_timing_csv(os):            node,name,deps,start,finish,duration,critical.
+ *
+ * A node that throws stops its successors; run() waits for the rest and rethrows the first
+ * exception. A graph can be run again (timings are overwritten).
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "task_scheduler.h"
+
+namespace quant {
+
+struct NodeTiming {
+    double start = 0.0, finish = 0.0;
+    double duration() const { return finish - start; }
+};
+
+class TaskGraph {
+  public:
+    using NodeId = std::size_t;
+
+    NodeId add(std::string name, std::function<void()> fn, std::vector<NodeId> deps = {}) {
+        const NodeId id = nodes_.size();
+        for (NodeId d : deps)
+            if (d >= id) throw std::invalid_argument("TaskGraph::add: dependency on an unknown node");
+        std::sort(deps.begin(), deps.end());
+        deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+        for (NodeId d : deps) nodes_[d].successors.push_back(id);
+        nodes_.push_back({std::move(name), std::move(fn), std::move(deps), {}});
+        return id;
+    }
+
+    std::size_t size() const { return nodes_.size(); }
+    const std::string& name(NodeId id) const { return nodes_[id].name; }
+    const std::vector<NodeId>& deps(NodeId id) const { return nodes_[id].deps; }
+
+    void run(TaskScheduler& s = TaskScheduler::global()) {
+        const std::size_t n = nodes_.size();
+        timings_.assign(n, {});
+        waiting_.reset(new std::atomic<std::size_t>[n]);
+        for (std::size_t i = 0; i < n; ++i) waiting_[i].store(nodes_[i].deps.size(), std::memory_order_relaxed);
+        t0_ = clock::now();
+
+        TaskGroup group(s);
+        for (NodeId i = 0; i < n; ++i)
+            if (nodes_[i].deps.empty()) group.run([this, &group, i] { execute(group, i); });
+        group.wait();
+    }
+
+    const std::vector<NodeTiming>& timings() const { return timings_; }
+
+    // Longest duration-weighted chain, from a root to a sink (by the last run's timings).
+    std::vector<NodeId> critical_path() const {
+        const std::size_t n = nodes_.size();
+        if (n == 0 || timings_.size() != n) return {};
+        std::vector<double> length(n);
+        std::vector<NodeId> via(n, n);
+        for (NodeId i = 0; i < n; ++i) {
+            double best = 0.0;
+            for (NodeId d : nodes_[i].deps)
+                if (length[d] > best || via[i] == n) { best = length[d]; via[i] = d; }
+            length[i] = best + timings_[i].duration();
+        }
+        NodeId end = static_cast<NodeId>(std::max_element(length.begin(), length.end()) - length.begin());
+        std::vector<NodeId> path;
+        for (NodeId i = end; i != n; i = via[i]) path.push_back(i);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // Total of node durations (the sequential work) and run makespan.
+    double total_work() const {
+        double w = 0.0;
+        for (const NodeTiming& t : timings_) w += t.duration();
+        return w;
+    }
+    double makespan() const {
+        double m = 0.0;
+        for (const NodeTiming& t : timings_) m = std::max(m, t.finish);
+        return m;
+    }
+
+    void write_timing_csv(std::ostream& os) const {
+        const std::vector<NodeId> path = critical_path();
+        std::vector<bool> critical(nodes_.size(), false);
+        for (NodeId i : path) critical[i] = true;
+        os << "node,name,deps,start,finish,duration,critical\n";
+        for (NodeId i = 0; i < timings_.size(); ++i) {
+            os << i << ',' << nodes_[i].name << ',';
+            for (std::size_t k = 0; k < nodes_[i].deps.size(); ++k) os << (k ? ";" : "") << nodes_[i].deps[k];
+            os << ',' << timings_[i].start << ',' << timings_[i].finish << ',' << timings_[i].duration() << ','
+               << (critical[i] ? 1 : 0) << '\n';
+        }
+    }
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    struct Node {
+        std::string name;
+        std::function<void()> fn;
+        std::vector<NodeId> deps;
+        std::vector<NodeId> successors;
+    };
+
+    double seconds_since_start() const { return std::chrono::duration<double>(clock::now() - t0_).count(); }
+
+    void execute(TaskGroup& group, NodeId i) {
+        timings_[i].start = seconds_since_start();
+        nodes_[i].fn();
+        timings_[i].finish = seconds_since_start();
+        for (NodeId s : nodes_[i].successors)
+            if (waiting_[s].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                group.run([this, &group, s] { execute(group, s); });
+    }
+
+    std::vector<Node> nodes_;
+    std::vector<NodeTiming> timings_;
+    std::unique_ptr<std::atomic<std::size_t>[]> waiting_;
+    clock::time_point t0_;
+};
+
+} // namespace quant
@@ -0,0 +1,341 @@
+#pragma once
+/**
+ * @file task_scheduler.h
+ * @brief Shared work-stealing task scheduler with fork/join, parallel_for and parallel_reduce.
+ *
+ * Exposes:
+ *  - WorkStealingDeque:      Chase–Lev deque (owner push/pop at the bottom, thieves steal
+ *                            from the top; the ring grows and old rings are retired).
+ *  - TaskScheduler:          one deque per worker thread plus a locked injection queue for
+ *                            threads outside the pool. TaskScheduler::global() is sized to the
+ *                            hardware (workers + the calling thread).
+ *  - TaskGroup:              run(f) forks, wait() joins; the waiting thread executes pending
+ *                            tasks instead of blocking, so groups nest freely. The first
+ *                            exception thrown by a task is rethrown from wait().
+ *  - parallel_for(b, e, grain, body):             body(lo, hi) over [b, e) in ranges ≤ grain.
+ *  - parallel_reduce(b, e, grain, id, map, combine): map(lo, hi) → T per range, combined
+ *                            along a fixed binary split tree.
+ *
+ * Ranges are split in halves until they fit the grain, so the split tree (and with it the
+ * parallel_reduce result) depends on (b, e, grain) only, never on the thread count or on
+ * which thread stole what. All engines share one pool, so nested calls (an MC run inside
+ * a portfolio loop, a sweep inside a scenario task) do not oversubscribe the cores.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace quant {
+
+class TaskGroup;
+class TaskScheduler;
+
+struct Task {
+    std::function<void()> fn;
+    TaskGroup* group;
+};
+
+// Chase–Lev deque (Lê, Pop, Cohen, Zappa Nardelli, PPoPP 2013 memory orderings).
+class WorkStealingDeque {
+  public:
+    explicit WorkStealingDeque(std::size_t capacity = 256) {
+        rings_.emplace_back(new Ring(capacity));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    // Owner only.
+    void push(Task* x) {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t t = top_.load(std::memory_order_acquire);
+        Ring* a = ring_.load(std::memory_order_relaxed);
+        if (b - t > static_cast<std::int64_t>(a->capacity) - 1) a = grow(a, t, b);
+        a->put(b, x);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only; nullptr when empty.
+    Task* pop() {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Ring* a = ring_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+        Task* x = nullptr;
+        if (t <= b) {
+            x = a->get(b);
+            if (t == b) {
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    x = nullptr;
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return x;
+    }
+
+    // Any thread; nullptr when empty or when another thief won the race.
+    Task* steal() {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        Task* x = ring_.load(std::memory_order_acquire)->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return x;
+    }
+
+  private:
+    struct Ring {
+        std::size_t capacity;   // power of two
+        std::unique_ptr<std::atomic<Task*>[]> slots;
+
+        explicit Ring(std::size_t c) : capacity(c), slots(new std::atomic<Task*>[c]) {}
+        // Release/acquire on the slot itself (on top of the paper's fences) publishes the
+        // task body to the thief in a way race checkers can see.
+        Task* get(std::int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_acquire); }
+        void put(std::int64_t i, Task* x) { slots[i & (capacity - 1)].store(x, std::memory_order_release); }
+    };
+
+    // Thieves may still be reading the old ring, so it stays alive until the deque dies.
+    Ring* grow(Ring* a, std::int64_t t, std::int64_t b) {
+        rings_.emplace_back(new Ring(2 * a->capacity));
+        Ring* g = rings_.back().get();
+        for (std::int64_t i = t; i < b; ++i) g->put(i, a->get(i));
+        ring_.store(g, std::memory_order_release);
+        return g;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    std::atomic<Ring*> ring_{nullptr};
+    std::vector<std::unique_ptr<Ring>> rings_;   // owner only
+};
+
+namespace detail {
+
+// Which scheduler (if any) owns the current thread, and its deque index there.
+struct SchedulerContext {
+    TaskScheduler* scheduler = nullptr;
+    std::size_t index = 0;
+};
+
+} // namespace detail
+
+class TaskScheduler {
+  public:
+    // threads = total parallelism including the calling thread (0 = hardware concurrency).
+    explicit TaskScheduler(unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        deques_.reserve(threads - 1);
+        for (unsigned w = 0; w + 1 < threads; ++w) deques_.emplace_back(new WorkStealingDeque);
+        for (unsigned w = 0; w + 1 < threads; ++w) workers_.emplace_back([this, w] { worker_loop(w); });
+    }
+
+    ~TaskScheduler() {
+        {
+            std::lock_guard<std::mutex> lk(sleep_mutex_);
+            stop_.store(true, std::memory_order_relaxed);
+        }
+        sleep_cv_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    static TaskScheduler& global() {
+        static TaskScheduler s;
+        return s;
+    }
+
+    // Threads that can run tasks at once: the workers plus one waiting caller.
+    unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+    void spawn(Task* t) {
+        if (current_.scheduler == this) {
+            deques_[current_.index]->push(t);
+        } else {
+            std::lock_guard<std::mutex> lk(inject_mutex_);
+            inject_.push_back(t);
+        }
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lk(sleep_mutex_);
+            sleep_cv_.notify_one();
+        }
+    }
+
+    // Runs one pending task if there is one; used by TaskGroup::wait to help instead of block.
+    bool try_run_one() {
+        Task* t = find_task();
+        if (!t) return false;
+        execute(t);
+        return true;
+    }
+
+  private:
+    static inline thread_local detail::SchedulerContext current_;
+
+    Task* find_task() {
+        const bool own = current_.scheduler == this;
+        if (own)
+            if (Task* t = deques_[current_.index]->pop()) return t;
+        {
+            // Workers take the oldest (largest) injected task; outside threads have no
+            // deque, so they take the newest, which keeps their helping depth-first.
+            std::lock_guard<std::mutex> lk(inject_mutex_);
+            if (!inject_.empty()) {
+                Task* t;
+                if (own) { t = inject_.front(); inject_.pop_front(); }
+                else     { t = inject_.back(); inject_.pop_back(); }
+                return t;
+            }
+        }
+        const std::size_t n = deques_.size();
+        const std::size_t start = own ? current_.index + 1 : 0;
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::size_t v = (start + k) % n;
+            if (own && v == current_.index) continue;
+            if (Task* t = deques_[v]->steal()) return t;
+        }
+        return nullptr;
+    }
+
+    static void execute(Task* t);
+
+    void worker_loop(std::size_t index) {
+        current_ = {this, index};
+        int idle = 0;
+        while (!stop_.load(std::memory_order_relaxed)) {
+            if (try_run_one()) { idle = 0; continue; }
+            if (++idle < 64) { std::this_thread::yield(); continue; }
+            // Sleep until something is spawned. The epoch is read before a last probe: a task
+            // spawned after the probe failed has bumped it, so the wait below returns at once.
+            const std::uint64_t seen = epoch_.load(std::memory_order_seq_cst);
+            if (try_run_one()) { idle = 0; continue; }
+            std::unique_lock<std::mutex> lk(sleep_mutex_);
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            sleep_cv_.wait(lk, [&] {
+                return stop_.load(std::memory_order_relaxed) || epoch_.load(std::memory_order_seq_cst) != seen;
+            });
+            sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+            idle = 0;
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkStealingDeque>> deques_;
+    std::vector<std::thread> workers_;
+    std::mutex inject_mutex_;
+    std::deque<Task*> inject_;
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<std::uint64_t> epoch_{0};
+    std::atomic<int> sleepers_{0};
+    std::atomic<bool> stop_{false};
+};
+
+class TaskGroup {
+  public:
+    explicit TaskGroup(TaskScheduler& s = TaskScheduler::global()) : scheduler_(s) {}
+    ~TaskGroup() {
+        // Tasks reference the group; never let it go out of scope with work in flight.
+        while (pending_.load(std::memory_order_acquire) > 0)
+            if (!scheduler_.try_run_one()) std::this_thread::yield();
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    TaskScheduler& scheduler() const { return scheduler_; }
+
+    template <class F>
+    void run(F&& f) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        scheduler_.spawn(new Task{std::function<void()>(std::forward<F>(f)), this});
+    }
+
+    void wait() {
+        while (pending_.load(std::memory_order_acquire) > 0)
+            if (!scheduler_.try_run_one()) std::this_thread::yield();
+        if (error_) {
+            std::exception_ptr e = error_;
+            error_ = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+  private:
+    friend class TaskScheduler;
+
+    void finish(std::exception_ptr e) {
+        if (e) {
+            std::lock_guard<std::mutex> lk(error_mutex_);
+            if (!error_) error_ = e;
+        }
+        pending_.fetch_sub(1, std::memory_order_release);
+    }
+
+    TaskScheduler& scheduler_;
+    std::atomic<std::size_t> pending_{0};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+inline void TaskScheduler::execute(Task* t) {
+    std::exception_ptr e;
+    try {
+        t->fn();
+    } catch (...) {
+        e = std::current_exception();
+    }
+    TaskGroup* g = t->group;
+    delete t;
+    g->finish(e);
+}
+
+// body(lo, hi) for disjoint ranges covering [begin, end), each at most `grain` long.
+template <class Body>
+void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, const Body& body,
+                  TaskScheduler& s = TaskScheduler::global()) {
+    grain = std::max<std::size_t>(grain, 1);
+    if (end <= begin) return;
+    if (end - begin <= grain) { body(begin, end); return; }
+    const std::size_t mid = begin + (end - begin) / 2;
+    TaskGroup g(s);
+    g.run([&] { parallel_for(mid, end, grain, body, s); });
+    parallel_for(begin, mid, grain, body, s);
+    g.wait();
+}
+
+// combine(map(lo, hi), ...) over the same halving tree as parallel_for; identity for an
+// empty range. combine must be associative for the result to mean anything, but the
+// grouping is fixed, so non-associative floating-point sums are still reproducible.
+template <class T, class Map, class Combine>
+T parallel_reduce(std::size_t begin, std::size_t end, std::size_t grain, T identity, const Map& map,
+                  const Combine& combine, TaskScheduler& s = TaskScheduler::global()) {
+    grain = std::max<std::size_t>(grain, 1);
+    if (end <= begin) return identity;
+    if (end - begin <= grain) return map(begin, end);
+    const std::size_t mid = begin + (end - begin) / 2;
+    T right = identity;
+    TaskGroup g(s);
+    g.run([&] { right = parallel_reduce(mid, end, grain, identity, map, combine, s); });
+    T left = parallel_reduce(begin, mid, grain, identity, map, combine, s);
+    g.wait();
+    return combine(left, right);
+}
+
+} // namespace quant
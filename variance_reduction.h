@@ -0,0 +1,130 @@
+#pragma once
+/**
+ * @file variance_reduction.h
+ * @brief Variance-reduced Monte Carlo for European calls (deep-OTM friendly).
+ *
+ * Exposes:
+ *  - bs_d2(S,K,r,q,σ,T):           d2 of the Black-Scholes call, as used by bs_price_call.
+ *  - optimal_is_shift(...):        drift shift μ for importance sampling, started from -d2.
+ *  - VarianceReduction:            flags for antithetic, moment matching, stratified sampling
+ *                                  on the first normal, and drift-shift importance sampling.
+ *  - mc_price_call(...):           MC estimate + standard error under any flag combination.
+ *
+ * Normals come from InverseCumulativeNormal applied (in batch) to pseudo-random or
+ * stratified uniforms; with importance sampling every payoff carries its likelihood ratio.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "InverseCumulativeNormal.h"
+
+namespace quant {
+
+// d2 = (ln(F/K) - σ²T/2) / (σ√T)
+inline double bs_d2(double S, double K, double r, double q, double sigma, double T) {
+    const double sigmaT = sigma * std::sqrt(T);
+    return (std::log(S / K) + (r - q - 0.5 * sigma * sigma) * T) / sigmaT;
+}
+
+// Drift shift that centres the sampling density on the mode of payoff × density.
+// S_T(z) = K exactly at z = -d2, so the mode lies just beyond it and solves
+// μ (S_T(μ) - K) = σ√T S_T(μ); a few safeguarded Newton steps from -d2 + σ√T find it.
+inline double optimal_is_shift(double S, double K, double r, double q, double sigma, double T) {
+    const double sigmaT = sigma * std::sqrt(T);
+    const double lnS0 = std::log(S) + (r - q - 0.5 * sigma * sigma) * T;
+    double mu = std::max(-bs_d2(S, K, r, q, sigma, T), 0.0) + sigmaT;
+    for (int iter = 0; iter < 20; ++iter) {
+        const double ST = std::exp(lnS0 + sigmaT * mu);
+        const double g  = mu * (ST - K) - sigmaT * ST;
+        const double dg = (ST - K) + mu * sigmaT * ST - sigmaT * sigmaT * ST;
+        if (dg <= 0.0) break;
+        const double step = g / dg;
+        mu -= step;
+        if (std::abs(step) < 1e-12) break;
+    }
+    return std::max(mu, 0.0);
+}
+
+struct VarianceReduction {
+    bool antithetic      = false;  // pair u with its reflection (1-u, or within the stratum)
+    bool moment_matching = false;  // rescale sample normals to mean 0, variance 1 (ignored if stratified)
+    bool stratified      = false;  // equal-probability strata on the first normal
+    bool importance      = false;  // drift shift z -> z + μ with likelihood-ratio weights
+    std::size_t strata   = 1024;
+};
+
+struct MCEstimate {
+    double mean;
+    double std_error;
+    std::size_t paths;
+};
+
+// Discounted European call payoff, n_paths terminal draws. With stratification every
+// stratum receives the same number of draws and the standard error is the stratified one.
+// Moment matching introduces an O(1/n) bias; its std_error is the naive sample estimate.
+inline MCEstimate mc_price_call(double S, double K, double r, double q, double sigma, double T,
+                                std::size_t n_paths, const VarianceReduction& vr = {},
+                                std::uint64_t seed = 42) {
+    const std::size_t L     = vr.stratified ? std::max<std::size_t>(vr.strata, 1) : 1;
+    const std::size_t group = vr.antithetic ? 2 : 1;
+    // Draws per stratum, at least two sampling units so a within-stratum variance exists.
+    const std::size_t per = std::max<std::size_t>((n_paths + L - 1) / L, 2 * group) / group * group;
+    const std::size_t n   = per * L;
+
+    std::mt19937_64 rng(seed);
+    std::vector<double> u(n), z(n);
+    for (std::size_t j = 0; j < L; ++j) {
+        for (std::size_t i = 0; i < per; i += group) {
+            const double U = (static_cast<double>(rng() >> 11) + 0.5) * 0x1p-53;
+            u[j * per + i] = (static_cast<double>(j) + U) / static_cast<double>(L);
+            if (vr.antithetic) u[j * per + i + 1] = (static_cast<double>(j) + 1.0 - U) / static_cast<double>(L);
+        }
+    }
+    const InverseCumulativeNormal icn;
+    icn(u.data(), z.data(), n);
+
+    if (vr.moment_matching && !vr.stratified) {
+        double m = 0.0, m2 = 0.0;
+        for (std::size_t i = 0; i < n; ++i) m += z[i];
+        m /= static_cast<double>(n);
+        for (std::size_t i = 0; i < n; ++i) m2 += (z[i] - m) * (z[i] - m);
+        const double scale = 1.0 / std::sqrt(m2 / static_cast<double>(n));
+        for (std::size_t i = 0; i < n; ++i) z[i] = (z[i] - m) * scale;
+    }
+
+    const double mu     = vr.importance ? optimal_is_shift(S, K, r, q, sigma, T) : 0.0;
+    const double DF     = std::exp(-r * T);
+    const double sigmaT = sigma * std::sqrt(T);
+    const double lnS0   = std::log(S) + (r - q - 0.5 * sigma * sigma) * T;
+
+    // Per stratum: mean and variance of sampling units (antithetic pairs count as one unit).
+    const std::size_t units = per / group;
+    double mean = 0.0, var = 0.0;
+    for (std::size_t j = 0; j < L; ++j) {
+        double um = 0.0, um2 = 0.0;
+        for (std::size_t k = 0; k < units; ++k) {
+            double x = 0.0;
+            for (std::size_t g = 0; g < group; ++g) {
+                const double y  = z[j * per + k * group + g] + mu;
+                const double lr = vr.importance ? std::exp(-mu * y + 0.5 * mu * mu) : 1.0;
+                x += DF * std::max(std::exp(lnS0 + sigmaT * y) - K, 0.0) * lr;
+            }
+            x /= static_cast<double>(group);
+            const double delta = x - um;
+            um += delta / static_cast<double>(k + 1);
+            um2 += delta * (x - um);
+        }
+        mean += um;
+        var  += um2 / static_cast<double>(units - 1) / static_cast<double>(units);
+    }
+    mean /= static_cast<double>(L);
+    var  /= static_cast<double>(L) * static_cast<double>(L);
+    return {mean, std::sqrt(var), n};
+}
+
+} // namespace quant